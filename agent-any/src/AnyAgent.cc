@@ -102,14 +102,15 @@
 
 AnyAgent::AnyAgent ()
     : description_read (false),
-      mtime (0),
       cache (YCPNull ()),
       cchanged (true),
       alldata (YCPNull ()),
       achanged (true),
+      acached (false),
       mName (YCPNull ()),
       isFillup (false),
       mSyntax (YCPNull ()),
+      mProgramEntry (-1),
       mHeader (YCPNull ())
 {
 }
@@ -120,6 +121,26 @@ AnyAgent::~AnyAgent ()
 }
 
 
+AnyAgent::FileKey::FileKey (const string & name, const struct stat & st)
+    : name (name),
+      dev (st.st_dev),
+      ino (st.st_ino),
+      size (st.st_size),
+      mtime (st.st_mtim.tv_sec),
+      mtime_nsec (st.st_mtim.tv_nsec)
+{
+}
+
+
+bool
+AnyAgent::FileKey::operator== (const FileKey & k) const
+{
+    return ino == k.ino && dev == k.dev && size == k.size
+	&& mtime == k.mtime && mtime_nsec == k.mtime_nsec
+	&& name == k.name;
+}
+
+
 YCPValue
 AnyAgent::otherCommand (const YCPTerm & term)
 {
@@ -226,6 +247,10 @@ AnyAgent::otherCommand (const YCPTerm & term)
 
 	mSyntax = term->value (3);
 
+	mProgram.clear ();
+	mProgramArgs.clear ();
+	mProgramEntry = compileSyntax (mSyntax);
+
 	// extract optional header description
 
 	if (term->size () > 4)
@@ -439,6 +464,29 @@ AnyAgent::Write (const YCPPath & path, const YCPValue & value,
 	return YCPBoolean (false);
     }
 
+    string sfname;
+
+    if (mName->isTerm ())
+    {
+	sfname = evalArg (arg);
+	if (sfname.empty ())
+	    return YCPBoolean (false);
+    }
+    else
+    {
+	sfname = mName->asString ()->value ();
+    }
+
+    // rewrite only the changed lines if possible
+
+    if (path->isRoot () && value->isList ()
+	&& writeRecords (sfname, value->asList (), arg))
+    {
+	// the next Read must not take the cache for the old contents
+	mkey = FileKey ();
+	return YCPBoolean (true);
+    }
+
     // convert value to string
 
     const string s = unparseData (syntax, value);
@@ -453,24 +501,13 @@ AnyAgent::Write (const YCPPath & path, const YCPValue & value,
 
     y2debug ("Write[%s]", s.c_str ());
     {
-	string sfname;
-	const char *fname;
-
-	if (mName->isTerm ())
-	{
-	    sfname = evalArg (arg);
-	    if (sfname.empty ())
-		return YCPBoolean (false);
-	}
-	else
-	{
-	    sfname = mName->asString ()->value ();
-	}
-
-	fname = sfname.c_str ();
+	const char *fname = sfname.c_str ();
 
 	y2debug (" to %s", fname);
 
+	// the next Read must not take the cache for the old contents
+	mkey = FileKey ();
+
 	std::ofstream dummy_file (targetPath(fname));
 	if (!dummy_file)
 	{
@@ -545,6 +582,9 @@ AnyAgent::validateCache (const YCPList & data, const YCPValue & arg)
 	YCPValue filedata = readFile (arg);
 	if (filedata.isNull () || !filedata->isList ())
 	    return filedata;
+	// same file as last time, no need to parse it again
+	if (acached && !cchanged)
+	    return cache;
 	alldata = filedata->asList ();
     }
     else
@@ -561,12 +601,13 @@ AnyAgent::validateCache (const YCPList & data, const YCPValue & arg)
     }
 
     cchanged = true;
+    mRecordEnd.clear ();
 
     // now parse file according to mComment/isFillup and mSyntax
 
     line_number = -1;		// initialize
     const char *line = "";
-    YCPValue value = parseData (line, mSyntax, false);
+    YCPValue value = parseData (line, mProgram[mProgramEntry], false);
 
     if (!value.isNull ())
     {
@@ -713,6 +754,9 @@ AnyAgent::readFile (const YCPValue & arg)
     struct stat buf;
     FILE *fp;
     string ss;
+    FileKey key;
+
+    acached = false;
 
     if (mName->isTerm ())
     {
@@ -729,7 +773,6 @@ AnyAgent::readFile (const YCPValue & arg)
     {
 
 	// always invalidate cache
-	buf.st_mtime = 0;
         fp = program_stream(ss.c_str(), this);
 
 	if (fp == 0)
@@ -741,10 +784,10 @@ AnyAgent::readFile (const YCPValue & arg)
     else
     {
         const char *s = ss.c_str();
-        // Check modify time if we can use cache
+        // Check file identity if we can use cache
         if (stat (targetPath(s).c_str(), &buf) != 0)
         {
-            mtime = 0;	// error case: reset mtime
+            mkey = FileKey ();	// error case: reset cache key
             if (errno == ENOENT)
             {
                 ycp2error ("File not found %s", s);
@@ -755,8 +798,12 @@ AnyAgent::readFile (const YCPValue & arg)
             return YCPNull ();
         }
 
-        if (buf.st_mtime == mtime)
+        key = FileKey (ss, buf);
+        if (key == mkey && !alldata.isNull ())
+        {
+            acached = true;
             return alldata;
+        }
 
         fp = file_stream(s, this);
 
@@ -785,7 +832,7 @@ AnyAgent::readFile (const YCPValue & arg)
 
     fclose (fp);
 
-    mtime = buf.st_mtime;
+    mkey = key;
     alldata = data;
     achanged = false;
 
@@ -793,6 +840,134 @@ AnyAgent::readFile (const YCPValue & arg)
 }
 
 
+/**
+ * isCommentLine
+ *
+ * true if getLine () skips the line
+ *
+ */
+
+bool
+AnyAgent::isCommentLine (const string & line) const
+{
+    return line.empty ()
+	|| (!isFillup && mComment.find_first_of (line[0]) != string::npos);
+}
+
+
+/**
+ * writeRecords
+ *
+ * If the syntax is a List () of lines, write value to the file
+ * reusing the lines of all list elements that did not change since
+ * the file was read. Comments are kept. Only changed elements are
+ * unparsed. The file is read first if the cache is not up to date,
+ * so the result does not depend on an earlier Read.
+ *
+ * return false if this is not possible, the caller must write the
+ * complete file then
+ *
+ */
+
+bool
+AnyAgent::writeRecords (const string & fname, const YCPList & value,
+			const YCPValue & arg)
+{
+    if (mType != MTYPE_FILE || isFillup || mProgramEntry < 0)
+	return false;
+
+    const SyntaxNode & syntax = mProgram[mProgramEntry];
+    if (syntax.op != SYN_LIST
+	|| argNode (syntax, 1).op != SYN_VERBOSE || argNode (syntax, 1).text != "\n")
+	return false;
+
+    // a new file has no comments to keep
+    struct stat buf;
+    if (stat (targetPath (fname).c_str (), &buf) != 0)
+	return false;
+
+    if (!(mkey == FileKey (fname, buf)) || cchanged)
+    {
+	YCPValue current = validateCache (YCPNull (), arg);
+	if (current.isNull () || !current->isList ()
+	    || stat (targetPath (fname).c_str (), &buf) != 0)
+	    return false;
+    }
+
+    if (alldata.isNull () || cache.isNull () || cchanged || !cache->isList ())
+	return false;
+
+    YCPList old_value = cache->asList ();
+    if ((int) mRecordEnd.size () != old_value->size () || value->size () == 0
+	|| (!mRecordEnd.empty () && mRecordEnd.back () >= alldata->size ()))
+	return false;
+
+    // the parsed lines must still be what is in the file
+    if (!(mkey == FileKey (fname, buf)))
+	return false;
+
+    const YCPValue element_syntax = mSyntax->asTerm ()->value (0);
+
+    string s;
+    int prev_end = -1;		// last line written from alldata
+    int changed = 0;
+
+    for (int i = 0; i < value->size (); i++)
+    {
+	const YCPValue v = value->value (i);
+
+	if (i < old_value->size ())
+	{
+	    const int end = mRecordEnd[i];
+	    if (v->equal (old_value->value (i)))
+	    {
+		// unchanged, copy its lines including preceding comments
+		for (int l = prev_end + 1; l <= end; l++)
+		    s += alldata->value (l)->asString ()->value ();
+		prev_end = end;
+		continue;
+	    }
+
+	    // keep preceding comments, drop the old lines
+	    for (int l = prev_end + 1; l <= end; l++)
+	    {
+		const string & line = alldata->value (l)->asString ()->value ();
+		if (isCommentLine (line))
+		    s += line;
+		else
+		    break;
+	    }
+	    prev_end = end;
+	}
+
+	const string data = unparseData (element_syntax, v);
+	if (data.empty ())
+	    return false;
+	s += data;
+	s += "\n";
+	changed++;
+    }
+
+    // trailing comments
+    for (int l = mRecordEnd.empty () ? 0 : mRecordEnd.back () + 1; l < alldata->size (); l++)
+    {
+	const string & line = alldata->value (l)->asString ()->value ();
+	if (isCommentLine (line))
+	    s += line;
+    }
+
+    y2debug ("writeRecords: %d of %d elements changed", changed, value->size ());
+
+    std::ofstream file (targetPath (fname));
+    if (!file)
+	return false;
+
+    file << s;
+    file.flush ();
+    return !file.fail ();
+}
+
+
 /**
  * writeFile
  *
@@ -16,9 +16,11 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <stack>
+#include <vector>
 #include <scr/SCRAgent.h>
 
 using std::stack;
+using std::vector;
 
 
 /**
@@ -33,17 +35,43 @@ class AnyAgent : public SCRAgent
      */
     bool description_read;
 
+    /**
+     * Identity of a file, it is considered unchanged as long as
+     * all of these stay the same.
+     */
+    struct FileKey
+    {
+	string name;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	time_t mtime;
+	long mtime_nsec;
+
+	FileKey () : dev (0), ino (0), size (0), mtime (0), mtime_nsec (0) {}
+	FileKey (const string & name, const struct stat & st);
+	bool operator== (const FileKey & k) const;
+    };
+
     /**
      * file cache
-     * mtime = file's mtime when alldata was filled
+     * mkey = file alldata was filled from, empty name if none
      * cache = parsed file
      * alldata = list of YCPStringRep with all data from file
+     * acached = readFile returned alldata unchanged
      */
-    time_t mtime;
+    FileKey mkey;
     YCPValue cache;
     bool cchanged;
     YCPList alldata;
     bool achanged;
+    bool acached;
+
+    /**
+     * If the syntax is a List () of lines, the index of the last line
+     * in alldata of each parsed list element. Used by writeRecords.
+     */
+    vector<int> mRecordEnd;
 
     /**
      * true if file is read-only
@@ -71,6 +99,60 @@ class AnyAgent : public SCRAgent
      */
     YCPValue mSyntax;
 
+    /**
+     * Set of characters for String () and Separator ()
+     */
+    struct CharSet
+    {
+	bool negated;		// String ("^...")
+	bool empty;		// no characters given (after the ^)
+	bool member[256];
+
+	CharSet ();
+	void assign (const char *set, bool allow_negation);
+	bool contains (char c) const { return member[(unsigned char) c]; }
+    };
+
+    /**
+     * Operations of the compiled syntax description
+     */
+    enum SyntaxOp {
+	SYN_OPTIONAL, SYN_CONTINUE, SYN_CHOICE, SYN_SEQUENCE, SYN_LIST,
+	SYN_TUPLE, SYN_VAR, SYN_NAME, SYN_VALUE, SYN_FILLUP, SYN_SKIP,
+	SYN_MATCH, SYN_SEPARATOR, SYN_STRING, SYN_OR, SYN_NUMBER, SYN_HEXVAL,
+	SYN_BOOLEAN, SYN_FLOAT, SYN_IP4NUMBER, SYN_HOSTNAME, SYN_USERNAME,
+	SYN_ELEMENT,	// <name> (<syntax>) inside a Tuple ()
+	SYN_VERBOSE,	// string constant
+	SYN_UNKNOWN,	// unknown term, parses to void
+	SYN_INVALID	// bad syntax, parse fails
+    };
+
+    /**
+     * One instruction of the compiled syntax description. The
+     * arguments are indices into mProgram, stored in mProgramArgs.
+     * For Choice () they come in pairs of match and action (-1 for
+     * no action).
+     */
+    struct SyntaxNode
+    {
+	SyntaxOp op;
+	enum { EOF_NULL, EOF_VOID, EOF_MATCH } at_eof;
+	int args;		// index of first argument in mProgramArgs
+	int nargs;		// number of arguments
+	string text;		// verbose match, element name or error
+	CharSet set;		// String (), Separator (), Whitespace ()
+	CharSet stripped;	// second argument of String ()
+	bool has_stripped;
+    };
+
+    /**
+     * mSyntax compiled once by compileSyntax, so that parsing the
+     * file does not need to interpret the YCP terms for every line.
+     */
+    vector<SyntaxNode> mProgram;
+    vector<int> mProgramArgs;
+    int mProgramEntry;
+
     /**
      * syntax description of header lines
      */
@@ -149,7 +231,7 @@ private:
     YCPValue parseHexval (char const *&lptr, bool optional);
     const string unparseHexval (const YCPValue & value);
 
-    YCPValue parseString (char const *&lptr, const char *set, const char *stripped,
+    YCPValue parseString (char const *&lptr, const CharSet & set, const CharSet * stripped,
 			  bool optional);
     const string unparseString (const YCPValue & syntax, const YCPValue & stripped,
 				const YCPValue & value);
@@ -163,10 +245,10 @@ private:
     YCPValue parseUsername (char const *&lptr, bool optional);
     const string unparseUsername (const YCPValue & value);
 
-    YCPValue parseVerbose (char const *&lptr, const char *match, bool optional);
+    YCPValue parseVerbose (char const *&lptr, const string & match, bool optional);
     const string unparseVerbose (const YCPValue & value);
 
-    YCPValue parseSeparator (char const *&lptr, const char *match, bool optional);
+    YCPValue parseSeparator (char const *&lptr, const CharSet & match, bool optional);
     const string unparseSeparator (const YCPValue & match);
 
     const char * getLine (void);
@@ -176,24 +258,31 @@ private:
     // Complex types (AnyAgentComplex)
     //
 
-    YCPValue parseChoice (char const *&line, const YCPList & syntax, bool optional);
+    int compileSyntax (const YCPValue & syntax);
+    int compileArgs (const YCPTerm & term, int count);
+    const SyntaxNode & argNode (const SyntaxNode & node, int i) const
+	{ return mProgram[mProgramArgs[node.args + i]]; }
+
+    YCPValue parseChoice (char const *&line, const SyntaxNode & syntax, bool optional);
     const string unparseChoice (const YCPList & syntax, const YCPValue & value);
 
-    YCPValue parseSequence (char const *&line, const YCPList & syntax, bool optional);
+    YCPValue parseSequence (char const *&line, const SyntaxNode & syntax, bool optional);
     const string unparseSequence (const YCPList & syntax, const YCPValue & value);
 
-    YCPValue parseList (char const *&line, const YCPList & syntax, bool optional);
+    YCPValue parseList (char const *&line, const SyntaxNode & syntax, bool optional);
     const string unparseList (const YCPList & syntax, const YCPValue & value);
 
-    YCPValue parseTuple (char const *&line, const YCPList & syntax, bool optional);
+    YCPValue parseTuple (char const *&line, const SyntaxNode & syntax, bool optional);
     const string unparseTuple (const YCPList & syntax, const YCPValue & value);
 
-    YCPValue parseData (char const *&line, const YCPValue & syntax, bool optional);
+    YCPValue parseData (char const *&line, const SyntaxNode & syntax, bool optional);
     const string unparseData (const YCPValue & syntax, const YCPValue & value);
 
     YCPValue validateCache (const YCPList & data, const YCPValue & arg = YCPNull ());
     YCPValue readFile (const YCPValue & arg);
     const string writeFile (const YCPValue & arg);
+    bool writeRecords (const string & fname, const YCPList & value, const YCPValue & arg);
+    bool isCommentLine (const string & line) const;
 
     string evalArg (const YCPValue & arg);
 
@@ -25,6 +25,31 @@
 #include <ycp/y2log.h>
 
 
+// character set for String () and Separator ()
+//
+
+AnyAgent::CharSet::CharSet ()
+    : negated (false),
+      empty (true)
+{
+    memset (member, 0, sizeof (member));
+}
+
+
+void
+AnyAgent::CharSet::assign (const char *set, bool allow_negation)
+{
+    negated = allow_negation && (*set == '^');
+    if (negated)
+	set++;
+
+    empty = (*set == 0);
+    memset (member, 0, sizeof (member));
+    for (; *set != 0; set++)
+	member[(unsigned char) *set] = true;
+}
+
+
 // parse IP4 number
 // nnn.nnn.nnn.nnn
 
@@ -226,25 +251,24 @@ AnyAgent::unparseHexval (const YCPValue & value)
 //
 
 YCPValue
-AnyAgent::parseString (char const *&lptr, const char *set, const char *stripped,
+AnyAgent::parseString (char const *&lptr, const CharSet & set, const CharSet * stripped,
 		       bool optional)
 {
     char const *start = lptr;
 
     // increment lptr according to match
 
-    if (*set == '^')
+    if (set.negated)
     {
-	set++;
-	while ((*lptr != 0) && (strchr (set, *lptr) == 0))
+	while ((*lptr != 0) && !set.contains (*lptr))
 	    lptr++;
     }
     else
     {
-	while ((*lptr != 0) && (strchr (set, *lptr) != 0))
+	while ((*lptr != 0) && set.contains (*lptr))
 	    lptr++;
     }
-    if ((start == lptr) && (*set != 0))
+    if ((start == lptr) && !set.empty)
 	return YCPNull ();
 
     // adjust start and end for stripping
@@ -253,9 +277,9 @@ AnyAgent::parseString (char const *&lptr, const char *set, const char *stripped,
 
     if (stripped != 0)
     {
-	while ((start < end) && (strchr (stripped, *start) != 0))
+	while ((start < end) && stripped->contains (*start))
 	    start++;
-	while ((start < end) && (strchr (stripped, *(end - 1)) != 0))
+	while ((start < end) && stripped->contains (*(end - 1)))
 	    end--;
     }
 
@@ -464,11 +488,11 @@ AnyAgent::unparseUsername (const YCPValue & value)
 
 
 YCPValue
-AnyAgent::parseVerbose (char const *&lptr, const char *match, bool optional)
+AnyAgent::parseVerbose (char const *&lptr, const string & match, bool optional)
 {
-    const int n = strlen (match);
+    const int n = match.size ();
 
-    if (strncmp (lptr, match, n) == 0)
+    if (strncmp (lptr, match.c_str (), n) == 0)
     {
 	const char * start = lptr;
 	lptr += n;
@@ -503,11 +527,11 @@ AnyAgent::unparseVerbose (const YCPValue & value)
 //
 
 YCPValue
-AnyAgent::parseSeparator (char const *&lptr, const char *match, bool optional)
+AnyAgent::parseSeparator (char const *&lptr, const CharSet & match, bool optional)
 {
     char const *start = lptr;
 
-    while ((*lptr != 0) && (strchr (match, *lptr) != 0))
+    while ((*lptr != 0) && match.contains (*lptr))
 	lptr++;
 
     return (optional || (lptr > start)) ?
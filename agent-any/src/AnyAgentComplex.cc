@@ -103,42 +103,25 @@ AnyAgent::putLine (const string s)
 //   parse one of many
 
 YCPValue
-AnyAgent::parseChoice (char const *&line, const YCPList & syntax, bool optional)
+AnyAgent::parseChoice (char const *&line, const SyntaxNode & syntax, bool optional)
 {
-    if ((line == 0) || syntax.isNull ())
+    if (line == 0)
 	return YCPNull ();
 
-    y2debug ("parseChoice ('%s',[%s])", line, syntax->toString ().c_str ());
+    y2debug ("parseChoice ('%s')", line);
 
-    for (int i = 0; i < syntax->size (); i++)
+    for (int i = 0; i < syntax.nargs; i += 2)
     {
-	YCPValue v = syntax->value (i);
-	if (v.isNull ())
-	{
-	    y2error ("Bad element in Choice()");
-	    return YCPNull ();
-	}
-	if (!v->isList ())
-	{
-	    y2error ("Choice element must be list");
-	    return YCPNull ();
-	}
-
-	YCPList element = v->asList ();
-	if ((element->size () <= 0) || (element->size () > 2))
+	const SyntaxNode & match = argNode (syntax, i);
+	if (match.op == SYN_INVALID)
 	{
-	    y2error ("Choice element list must have 1 or 2 entries");
+	    // bad Choice () element, see compileSyntax
+	    y2error ("%s", match.text.c_str ());
 	    return YCPNull ();
 	}
 
-	YCPValue match = element->value (0);
-
-	// get optional action
-
-	YCPValue action = (element->size () > 1) ? element->value (1) : YCPNull ();
-
 	// force match
-	y2debug ("choice (%d)", i);
+	y2debug ("choice (%d)", i / 2);
 
 	char const *try_line = line;
 
@@ -148,9 +131,11 @@ AnyAgent::parseChoice (char const *&line, const YCPList & syntax, bool optional)
 	if (!currentMatch.isNull ())
 	{
 	    line = try_line;
-	    y2debug ("choice (%d) match", i);
-	    if (!action.isNull ())
-		return parseData (line, action, optional);
+	    y2debug ("choice (%d) match", i / 2);
+
+	    // optional action
+	    if (mProgramArgs[syntax.args + i + 1] >= 0)
+		return parseData (line, argNode (syntax, i + 1), optional);
 	    else
 		return currentMatch;
 	}
@@ -174,22 +159,18 @@ AnyAgent::unparseChoice (const YCPList & syntax, const YCPValue & value)
 //   parse all of many
 
 YCPValue
-AnyAgent::parseSequence (char const *&line, const YCPList & syntax,
+AnyAgent::parseSequence (char const *&line, const SyntaxNode & syntax,
 			 bool optional)
 {
     YCPValue element = YCPNull ();
-    if (syntax.isNull ())
-	return element;
 
-    y2debug ("parseSequence ('%s',[%s])", line, syntax->toString ().c_str ());
+    y2debug ("parseSequence ('%s')", line);
 
     char const *lstart = line;
 
-    for (int i = 0; i < syntax->size (); i++)
+    for (int i = 0; i < syntax.nargs; i++)
     {
-	element = syntax->value (i);
-
-	element = parseData (line, element, optional);
+	element = parseData (line, argNode (syntax, i), optional);
 
 	if (element.isNull ())
 	{
@@ -217,19 +198,22 @@ AnyAgent::unparseSequence (const YCPList & syntax, const YCPValue & value)
 //
 
 YCPValue
-AnyAgent::parseList (char const *&line, const YCPList & syntax, bool optional)
+AnyAgent::parseList (char const *&line, const SyntaxNode & syntax, bool optional)
 {
-    if (syntax.isNull ())
-	return YCPNull ();
+    y2debug ("parseList ('%s')", line);
+
+    const SyntaxNode & element = argNode (syntax, 0);
+    const SyntaxNode & separator = argNode (syntax, 1);
 
-    y2debug ("parseList ('%s',[%s])", line, syntax->toString ().c_str ());
+    // remember the lines of the elements of the toplevel list
+    const bool toplevel = (&syntax == &mProgram[mProgramEntry]);
 
     YCPList list;
 
     for (;;)
     {
 	// value of line
-	YCPValue vl = parseData (line, syntax->value (0), optional);
+	YCPValue vl = parseData (line, element, optional);
 	optional = false;
 	if (vl.isNull ())
 	    break;
@@ -237,9 +221,11 @@ AnyAgent::parseList (char const *&line, const YCPList & syntax, bool optional)
 	    list->add (vl);
 	y2debug ("vl (%s)", vl->toString ().c_str ());
 	// value of separator/string
-	YCPValue vs = parseData (line, syntax->value (1), false);
+	YCPValue vs = parseData (line, separator, false);
 	if (vs.isNull ())
 	    break;
+	if (toplevel && !vl->isVoid ())
+	    mRecordEnd.push_back (line_number);
     }
 
     y2debug ("list (%s)", list->toString ().c_str ());
@@ -316,24 +302,19 @@ AnyAgent::unparseList (const YCPList & syntax, const YCPValue & value)
 //
 
 YCPValue
-AnyAgent::parseTuple (char const *&line, const YCPList & syntax, bool optional)
+AnyAgent::parseTuple (char const *&line, const SyntaxNode & syntax, bool optional)
 {
-    if (syntax.isNull ())
-	return YCPNull ();
-
     if (line == 0)
 	return YCPNull ();
 
-    y2debug ("parseTuple (%s,%s)", line, syntax->toString ().c_str ());
+    y2debug ("parseTuple (%s)", line);
     YCPMap map;
 
     tupleContinue = false;
 
-    for (int i = 0; i < syntax->size (); i++)
+    for (int i = 0; i < syntax.nargs; i++)
     {
-	YCPValue element_syntax = syntax->value (i);
-
-	if (parseData (line, element_syntax, optional).isNull ())
+	if (parseData (line, argNode (syntax, i), optional).isNull ())
 	{
 	    if (!optional)
 		return YCPNull ();
@@ -354,7 +335,7 @@ AnyAgent::parseTuple (char const *&line, const YCPList & syntax, bool optional)
 	    tupleValue.top () = YCPNull ();
 	}
 
-	if (tupleContinue && (i == (syntax->size () - 1)))
+	if (tupleContinue && (i == (syntax.nargs - 1)))
 	{
 	    tupleContinue = false;
 	    i = -1;		// restart at 0
@@ -423,301 +404,418 @@ AnyAgent::unparseTuple (const YCPList & syntax, const YCPValue & value)
 }
 
 
-// parseData
-// toplevel parsing function
-// @return YCPNull if parsing failed like invalid syntax or EOF when some data
-//   needed. It returns YCPVoid if element is optional and not presented or just
-//   unwinding data like Var or Skip or if Or failed to match any of its
-//   elements. Otherwise it returns parsed data according to syntax parameter.
-YCPValue
-AnyAgent::parseData (char const *&line, const YCPValue & syntax, bool optional)
+// compileSyntax
+// translate the syntax description to mProgram once, resolving term
+// names, separators and character sets, so that parseData does not
+// have to look at the YCP terms for every line
+// @return index of the compiled node in mProgram
+
+int
+AnyAgent::compileSyntax (const YCPValue & syntax)
 {
+    SyntaxNode node;
+    node.op = SYN_INVALID;
+    node.at_eof = SyntaxNode::EOF_NULL;
+    node.args = mProgramArgs.size ();
+    node.nargs = 0;
+    node.has_stripped = false;
+
     if (syntax.isNull ())
-	return YCPNull ();
-    if ((line == 0) || (*line == 0))
-	line = getLine ();
-    if (line == 0)
     {
-        // If the syntax being parsed does not need any string, then EOF is in fact OK
-        if (syntax->valuetype() == YT_TERM)
-        {
-	    YCPTerm term = syntax->asTerm ();
-	    const string s = term->name ();
-            if (s == "Optional" || s == "Skip")
-		return YCPVoid ();
-            else if (s == "Match")
-		return currentMatch;
-        }
-
-	return YCPNull ();
+	// parse fails silently
     }
-
-    y2debug ("parseData %s('%s',[%s])", (optional ? "?" : "!"), line,
-	     syntax->toString ().c_str ());
-
-    switch (syntax->valuetype ())
+    else if (syntax->isString ())
     {
-	case YT_TERM: {
-
-	    YCPTerm term = syntax->asTerm ();
-	    const string s = term->name ();
-	    y2debug ("YT_TERM (%s)", s.c_str ());
-
-	    // Optional
-
-	    if (s == "Optional" && term->size () > 0)
-	    {
-		YCPValue ov = parseData (line, term->value (0), true);
-		if (ov.isNull ())
-		    ov = YCPVoid ();
-		return ov;
-	    }
-
-	    // Continue
-
-	    else if (s == "Continue" && term->size () > 0)
-	    {
-		YCPValue tv = parseData (line, term->value (0), false);
-		if (!tv.isNull ())
-		    tupleContinue = true;
-		return tv;
-	    }
-
-	    // Choice
-
-	    else if (s == "Choice" && term->size () > 0)
-	    {
-		return parseChoice (line, term->args (), optional);
-	    }
-
-	    // Sequence
-
-	    else if (s == "Sequence" && term->size () > 0)
-	    {
-		return parseSequence (line, term->args (), optional);
-	    }
-
-	    // List
-
-	    else if (s == "List" && term->size () == 2)
+	node.op = SYN_VERBOSE;
+	node.text = syntax->asString ()->value ();
+    }
+    else if (syntax->isTerm ())
+    {
+	YCPTerm term = syntax->asTerm ();
+	const string s = term->name ();
+	const int size = term->size ();
+
+	// at EOF these do not need any data
+	if (s == "Optional" || s == "Skip")
+	    node.at_eof = SyntaxNode::EOF_VOID;
+	else if (s == "Match")
+	    node.at_eof = SyntaxNode::EOF_MATCH;
+
+	// same order of checks as always done by parseData, a term with
+	// a wrong number of arguments may match a later check
+
+	node.op = SYN_UNKNOWN;
+	node.text = s;
+
+	if (s == "Optional" && size > 0)
+	    node.op = SYN_OPTIONAL;
+	else if (s == "Continue" && size > 0)
+	    node.op = SYN_CONTINUE;
+	else if (s == "Choice" && size > 0)
+	    node.op = SYN_CHOICE;
+	else if (s == "Sequence" && size > 0)
+	    node.op = SYN_SEQUENCE;
+	else if (s == "List" && size == 2)
+	    node.op = SYN_LIST;
+	else if (s == "Tuple" && size > 0)
+	    node.op = SYN_TUPLE;
+	else if (s == "Var" && size > 0)
+	    node.op = SYN_VAR;
+	else if (s == "Name" && size == 1)
+	    node.op = SYN_NAME;
+	else if (s == "Value" && size == 1)
+	    node.op = SYN_VALUE;
+	else if (isFillup && s == "Fillup" && size == 0)
+	    node.op = SYN_FILLUP;	// only inside Tuple ()
+	else if (s == "Skip")
+	    node.op = SYN_SKIP;
+	else if (s == "Match")
+	    node.op = SYN_MATCH;
+	else if (s == "Separator" && size == 1)
+	{
+	    if (term->value (0)->isString ())
 	    {
-		return parseList (line, term->args (), optional);
+		node.op = SYN_SEPARATOR;
+		node.set.assign (term->value (0)->asString ()->value_cstr (), false);
 	    }
-
-	    // Tuple
-
-	    else if (s == "Tuple" && term->size () > 0)
+	    else
 	    {
-		tupleName.push ("");
-		tupleValue.push (YCPNull ());
-		YCPValue tv = parseTuple (line, term->args (), optional);
-		tupleName.pop ();
-		tupleValue.pop ();
-		return tv;
+		node.op = SYN_INVALID;
+		node.text = "Separator () needs a string";
 	    }
-
-	    // Var
-
-	    else if (s == "Var" && term->size () > 0)
+	}
+	else if (s == "Whitespace")
+	{
+	    node.op = SYN_SEPARATOR;
+	    node.set.assign (" \t", false);
+	}
+	else if (s == "String" && size > 0)
+	{
+	    node.op = SYN_INVALID;
+	    node.text = "";
+	    if (size <= 2 && term->value (0)->isString ()
+		&& (size == 1 || term->value (1)->isString ()))
 	    {
-		for (int i = 0; i < term->size (); i++)
+		node.op = SYN_STRING;
+		node.set.assign (term->value (0)->asString ()->value_cstr (), true);
+		if (size == 2)
 		{
-		    if (parseData (line, term->value (i), optional).isNull ())
-			break;
+		    node.has_stripped = true;
+		    node.stripped.assign (term->value (1)->asString ()->value_cstr (), false);
 		}
-		return YCPVoid ();
 	    }
+	    else if (size <= 2)
+	    {
+		node.text = "String () needs string arguments";
+	    }
+	}
+	else if (s == "Or" && size > 0)
+	    node.op = SYN_OR;
+	else if (s == "Number")
+	    node.op = SYN_NUMBER;
+	else if (s == "Hexval")
+	    node.op = SYN_HEXVAL;
+	else if (s == "Boolean")
+	    node.op = SYN_BOOLEAN;
+	else if (s == "Float")
+	    node.op = SYN_FLOAT;
+	else if (s == "Ip4Number")
+	    node.op = SYN_IP4NUMBER;
+	else if (s == "Hostname")
+	    node.op = SYN_HOSTNAME;
+	else if (s == "Username")
+	    node.op = SYN_USERNAME;
+	else if (islower (s[0]) && size == 1)
+	    node.op = SYN_ELEMENT;	// only inside Tuple ()
+
+	switch (node.op)
+	{
+	    case SYN_OPTIONAL:
+	    case SYN_CONTINUE:
+	    case SYN_NAME:
+	    case SYN_VALUE:
+	    case SYN_ELEMENT:
+		node.args = compileArgs (term, 1);
+		node.nargs = 1;
+		break;
 
-	    // Name
+	    case SYN_SEQUENCE:
+	    case SYN_LIST:
+	    case SYN_TUPLE:
+	    case SYN_VAR:
+	    case SYN_OR:
+		node.args = compileArgs (term, size);
+		node.nargs = size;
+		break;
 
-	    else if (s == "Name" && term->size () == 1)
+	    case SYN_CHOICE:
 	    {
-		if (!mReadOnly)
-		{
-		    y2error ("'Name' not allowed for writable agents");
-		    return YCPNull ();
-		}
-		YCPValue tn = parseData (line, term->value (0), false);
-		if (!tn.isNull () && tupleName.size () > 0)
+		// pairs of match and optional action
+		vector<int> args;
+		for (int i = 0; i < size; i++)
 		{
-		    if (tn->isString ())
-			tupleName.top () = tn->asString ()->value ();
+		    YCPValue v = term->value (i);
+		    int match = -1, action = -1;
+		    if (!v->isList ()
+			|| v->asList ()->size () <= 0
+			|| v->asList ()->size () > 2)
+		    {
+			SyntaxNode bad;
+			bad.op = SYN_INVALID;
+			bad.at_eof = SyntaxNode::EOF_NULL;
+			bad.args = bad.nargs = 0;
+			bad.has_stripped = false;
+			bad.text = !v->isList ()
+			    ? "Choice element must be list"
+			    : "Choice element list must have 1 or 2 entries";
+			match = mProgram.size ();
+			mProgram.push_back (bad);
+		    }
 		    else
-			tupleName.top () = tn->toString ();
-		    y2debug ("Name: %s", tn->toString ().c_str ());
+		    {
+			YCPList element = v->asList ();
+			match = compileSyntax (element->value (0));
+			if (element->size () > 1)
+			    action = compileSyntax (element->value (1));
+		    }
+		    args.push_back (match);
+		    args.push_back (action);
 		}
-		return tn;
+		node.args = mProgramArgs.size ();
+		node.nargs = args.size ();
+		mProgramArgs.insert (mProgramArgs.end (), args.begin (), args.end ());
+		break;
 	    }
 
-	    // Value
-
-	    else if (s == "Value" && term->size () == 1)
-	    {
-		YCPValue tv = parseData (line, term->value (0), false);
-		if (!tv.isNull () && tupleValue.size () > 0)
-		    tupleValue.top () = tv;
-		// y2debug ("Value: %p", tv);
-		return tv;
-	    }
+	    default:
+		break;
+	}
+    }
+    else
+    {
+	node.text = "parseData: unknown syntax " + syntax->toString ();
+    }
 
-	    // Fillup
+    mProgram.push_back (node);
+    return mProgram.size () - 1;
+}
 
-	    else if (isFillup && (s == "Fillup") &&	// fillup allowed and Fillup () found
-		     (term->size () == 0) && (tupleName.size () > 0))
-	    {		// inside Tuple ()
-		string fillup;
-		while ((line != 0)
-		       && (mComment.find_first_of (line[0]) != string::npos))
-		{
-		    fillup = fillup + line;
-		    line = getLine ();
-		}
-		tupleName.top () = KEY4FILLUP;
-		tupleValue.top () = YCPString (fillup);
-		return tupleValue.top ();
-	    }
 
-	    // Skip
+// compileArgs
+// compile the first count term arguments, store their indices next
+// to each other in mProgramArgs
+// @return index of the first argument in mProgramArgs
 
-	    else if (s == "Skip")
-	    {
-		return YCPVoid ();
-	    }
+int
+AnyAgent::compileArgs (const YCPTerm & term, int count)
+{
+    // compile first, arguments may have arguments themselves
+    vector<int> args;
+    for (int i = 0; i < count; i++)
+	args.push_back (compileSyntax (term->value (i)));
+
+    int first = mProgramArgs.size ();
+    mProgramArgs.insert (mProgramArgs.end (), args.begin (), args.end ());
+    return first;
+}
 
-	    // Match
 
-	    else if (s == "Match")
-	    {
+// parseData
+// toplevel parsing function, runs the syntax compiled by compileSyntax
+// @return YCPNull if parsing failed like invalid syntax or EOF when some data
+//   needed. It returns YCPVoid if element is optional and not presented or just
+//   unwinding data like Var or Skip or if Or failed to match any of its
+//   elements. Otherwise it returns parsed data according to syntax parameter.
+YCPValue
+AnyAgent::parseData (char const *&line, const SyntaxNode & syntax, bool optional)
+{
+    if ((line == 0) || (*line == 0))
+	line = getLine ();
+    if (line == 0)
+    {
+        // If the syntax being parsed does not need any string, then EOF is in fact OK
+	switch (syntax.at_eof)
+	{
+	    case SyntaxNode::EOF_VOID:
+		return YCPVoid ();
+	    case SyntaxNode::EOF_MATCH:
 		return currentMatch;
-	    }
+	    default:
+		return YCPNull ();
+	}
+    }
 
-	    // Separator
+    y2debug ("parseData %s('%s',%d)", (optional ? "?" : "!"), line, syntax.op);
 
-	    else if (s == "Separator" && term->size () == 1)
-	    {
-		return parseSeparator (line, term->value (0)->asString ()->value ().c_str (),
-				       optional);
-	    }
+    switch (syntax.op)
+    {
+	case SYN_OPTIONAL:
+	{
+	    YCPValue ov = parseData (line, argNode (syntax, 0), true);
+	    if (ov.isNull ())
+		ov = YCPVoid ();
+	    return ov;
+	}
 
-	    // Whitespace
+	case SYN_CONTINUE:
+	{
+	    YCPValue tv = parseData (line, argNode (syntax, 0), false);
+	    if (!tv.isNull ())
+		tupleContinue = true;
+	    return tv;
+	}
 
-	    else if (s == "Whitespace")
-	    {
-		return parseSeparator (line, " \t", optional);
-	    }
+	case SYN_CHOICE:
+	    return parseChoice (line, syntax, optional);
 
-	    // String
+	case SYN_SEQUENCE:
+	    return parseSequence (line, syntax, optional);
 
-	    else if (s == "String" && term->size () > 0)
-	    {
-		if (term->size () == 1)
-		    return parseString (line, term->value (0)->asString ()->value ().c_str (),
-					0, optional);
-		if (term->size () == 2)
-		    return parseString (line, term->value (0)->asString ()->value ().c_str (),
-					term->value (1)->asString ()->value ().c_str (),
-					optional);
-	    }
+	case SYN_LIST:
+	    return parseList (line, syntax, optional);
 
-	    // Or
+	case SYN_TUPLE:
+	{
+	    tupleName.push ("");
+	    tupleValue.push (YCPNull ());
+	    YCPValue tv = parseTuple (line, syntax, optional);
+	    tupleName.pop ();
+	    tupleValue.pop ();
+	    return tv;
+	}
 
-	    else if (s == "Or" && term->size () > 0)
+	case SYN_VAR:
+	{
+	    for (int i = 0; i < syntax.nargs; i++)
 	    {
-		const char *ltry = line;
-		bool lopt = false;
-		for (int i = 0; i < term->size (); i++)
-		{
-		    if (i == term->size () - 1)	// pass optional on last try
-			lopt = optional;
-		    YCPValue vtry = parseData (ltry, term->value (i), lopt);
-		    if (!vtry.isNull ())
-		    {
-			y2debug ("Or () success");
-			line = ltry;
-			return vtry;
-		    }
-		}
-		y2debug ("Or () failed");
-		return YCPVoid ();
+		if (parseData (line, argNode (syntax, i), optional).isNull ())
+		    break;
 	    }
+	    return YCPVoid ();
+	}
 
-	    // Number
-
-	    else if (s == "Number")
+	case SYN_NAME:
+	{
+	    if (!mReadOnly)
 	    {
-		return parseNumber (line, optional);
+		y2error ("'Name' not allowed for writable agents");
+		return YCPNull ();
 	    }
-
-	    // Hexval
-
-	    else if (s == "Hexval")
+	    YCPValue tn = parseData (line, argNode (syntax, 0), false);
+	    if (!tn.isNull () && tupleName.size () > 0)
 	    {
-		return parseHexval (line, optional);
+		if (tn->isString ())
+		    tupleName.top () = tn->asString ()->value ();
+		else
+		    tupleName.top () = tn->toString ();
+		y2debug ("Name: %s", tn->toString ().c_str ());
 	    }
+	    return tn;
+	}
 
-	    // Boolean
+	case SYN_VALUE:
+	{
+	    YCPValue tv = parseData (line, argNode (syntax, 0), false);
+	    if (!tv.isNull () && tupleValue.size () > 0)
+		tupleValue.top () = tv;
+	    return tv;
+	}
 
-	    else if (s == "Boolean")
+	case SYN_FILLUP:
+	{
+	    if (tupleName.size () == 0)		// not inside Tuple ()
+		break;
+	    string fillup;
+	    while ((line != 0)
+		   && (mComment.find_first_of (line[0]) != string::npos))
 	    {
-		return parseBoolean (line, optional);
+		fillup = fillup + line;
+		line = getLine ();
 	    }
+	    tupleName.top () = KEY4FILLUP;
+	    tupleValue.top () = YCPString (fillup);
+	    return tupleValue.top ();
+	}
 
-	    // Float
+	case SYN_SKIP:
+	    return YCPVoid ();
 
-	    else if (s == "Float")
-	    {
-		return parseFloat (line, optional);
-	    }
+	case SYN_MATCH:
+	    return currentMatch;
 
-	    // Ip4Number
+	case SYN_SEPARATOR:
+	    return parseSeparator (line, syntax.set, optional);
 
-	    else if (s == "Ip4Number")
+	case SYN_STRING:
+	    return parseString (line, syntax.set,
+				syntax.has_stripped ? &syntax.stripped : 0,
+				optional);
+
+	case SYN_OR:
+	{
+	    const char *ltry = line;
+	    bool lopt = false;
+	    for (int i = 0; i < syntax.nargs; i++)
 	    {
-		return parseIp4Number (line, optional);
+		if (i == syntax.nargs - 1)	// pass optional on last try
+		    lopt = optional;
+		YCPValue vtry = parseData (ltry, argNode (syntax, i), lopt);
+		if (!vtry.isNull ())
+		{
+		    y2debug ("Or () success");
+		    line = ltry;
+		    return vtry;
+		}
 	    }
+	    y2debug ("Or () failed");
+	    return YCPVoid ();
+	}
 
-	    // Hostname
+	case SYN_NUMBER:
+	    return parseNumber (line, optional);
 
-	    else if (s == "Hostname")
-	    {
-		return parseHostname (line, optional);
-	    }
+	case SYN_HEXVAL:
+	    return parseHexval (line, optional);
 
-	    // Username
+	case SYN_BOOLEAN:
+	    return parseBoolean (line, optional);
 
-	    else if (s == "Username")
-	    {
-		return parseUsername (line, optional);
-	    }
+	case SYN_FLOAT:
+	    return parseFloat (line, optional);
 
-	    // <name>
+	case SYN_IP4NUMBER:
+	    return parseIp4Number (line, optional);
 
-	    else if (islower (s[0]) && tupleName.size () > 0 && (term->size () == 1))
-	    {
-		tupleName.top () = s;
-		tupleValue.top () = parseData (line, term->value (0), optional);
-		return tupleValue.top ();
-	    }
+	case SYN_HOSTNAME:
+	    return parseHostname (line, optional);
 
-	    else
-	    {
-		y2error ("parseData: unknown term '%s'", s.c_str ());
-		return YCPVoid ();
-	    }
-	} break;
+	case SYN_USERNAME:
+	    return parseUsername (line, optional);
 
-	case YT_STRING:
+	case SYN_ELEMENT:
+	{
+	    if (tupleName.size () == 0)		// not inside Tuple ()
+		break;
+	    tupleName.top () = syntax.text;
+	    tupleValue.top () = parseData (line, argNode (syntax, 0), optional);
+	    return tupleValue.top ();
+	}
+
+	case SYN_VERBOSE:
 	    y2debug ("YT_STRING");
-	    return parseVerbose (line, syntax->asString ()->value ().c_str (),
-				 optional);
-	    break;
+	    return parseVerbose (line, syntax.text, optional);
 
-	default:
-	    y2error ("parseData: unknown syntax %s", syntax->toString ().c_str ());
+	case SYN_UNKNOWN:
 	    break;
+
+	case SYN_INVALID:
+	    if (!syntax.text.empty ())
+		y2error ("%s", syntax.text.c_str ());
+	    return YCPNull ();
     }
 
-    return YCPNull ();
+    y2error ("parseData: unknown term '%s'", syntax.text.c_str ());
+    return YCPVoid ();
 }
 
 
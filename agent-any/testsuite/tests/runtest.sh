@@ -3,4 +3,13 @@
 unset Y2DEBUG
 unset Y2DEBUGGER
 
+# the write tests work on a copy of their .in file, tmp.data.<name>,
+# and may have a script that runs alongside to change it
+base=${1%.ycp}
+data=tmp.data.$(basename $base)
+[ -f $base.in ] && cp $base.in $data
+[ -x $base.sh ] && $base.sh $data $2 &
+
 (./runag_anyagent -l - $1 >$2) 2>&1 | grep -F -v " <0> " | grep -v "^$" | sed 's/^....-..-.. ..:..:.. [^)]*) //g' > $3
+wait
+exit 0
@@ -0,0 +1,12 @@
+#!/bin/bash
+#
+# called by runtest.sh in the background with the data file and the
+# stdout file of write_ondisk.ycp: edit the data file once the first
+# Read has printed its result
+#
+
+for ((i = 0; i < 100; i++)); do
+    [ -s "$2" ] && break
+    sleep 0.05
+done
+sed -i 's/^# first$/# first, edited on disk/' "$1"
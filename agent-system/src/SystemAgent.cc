@@ -15,6 +15,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <fnmatch.h>
 #include <netdb.h>
 #include <resolv.h>
 #include <signal.h>
@@ -22,11 +23,13 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <linux/lp.h>
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <stdexcept>
@@ -34,6 +37,7 @@
 #include <YCP.h>
 #include <ycp/pathsearch.h>
 #include <ycp/Parser.h>
+#include <ycp/Bytecode.h>
 #include <ycp/y2log.h>
 
 #include "SystemAgent.h"
@@ -140,31 +144,132 @@ SystemAgent::~SystemAgent ()
 
 
 /**
- * Read file to string
+ * Buffer for read_fd_range, backed by a string
  */
-static int read_file_to_string (const char* filename, string& output)
+struct StringReadBuffer
 {
-    int fd = open (filename, O_RDONLY);
-    output = "";
-    if (fd < 0)
+    string& s;
+
+    StringReadBuffer (string& s) : s (s) {}
+
+    char* resize (size_t size) { s.resize (size); return &s[0]; }
+};
+
+
+/**
+ * Buffer for read_fd_range, backed by an array allocated with new [].
+ * The array can be handed over to YCPByteblock without a copy.
+ */
+struct ByteReadBuffer
+{
+    unsigned char* data;
+    size_t size;
+
+    ByteReadBuffer () : data (0), size (0) {}
+    ~ByteReadBuffer () { delete [] data; }
+
+    char* resize (size_t newsize)
     {
-	return errno;
+	if (data && newsize == size)
+	    return (char*) data;		// the final resize of an exact read
+
+	unsigned char* tmp = new unsigned char [newsize ? newsize : 1];
+	memcpy (tmp, data, std::min (size, newsize));
+	delete [] data;
+	data = tmp;
+	size = newsize;
+	return (char*) data;
     }
 
-    while (true)
+    unsigned char* release () { unsigned char* tmp = data; data = 0; size = 0; return tmp; }
+};
+
+
+/**
+ * Read length bytes starting at offset from fd into buffer. A negative
+ * length reads up to the end of file.
+ *
+ * Regular files are sized with fstat and read in one go. Files that
+ * do not report a size (/proc, pipes) are read into a buffer that
+ * grows geometrically. Embedded NUL characters are preserved.
+ *
+ * @return 0 on success, errno otherwise
+ */
+template <class Buffer>
+static int read_fd_range (int fd, off_t offset, long long length, Buffer& buffer)
+{
+    struct stat sb;
+    if (fstat (fd, &sb) != 0)
+	return errno;
+
+    // a regular file is read as it was at the time of fstat
+    bool sized = S_ISREG (sb.st_mode) && sb.st_size > 0;
+    size_t expected = 4096;
+    if (sized)
+	expected = sb.st_size > offset ? sb.st_size - offset : 0;
+    if (length >= 0 && (size_t) length < expected)
+	expected = length;
+
+    size_t capacity = expected;
+    size_t used = 0;
+    char* data = buffer.resize (capacity);
+
+    while (length < 0 || used < (size_t) length)
     {
-	char buffer[4096];
-	ssize_t bytes_read = read (fd, buffer, 4095);
-	if (bytes_read <= 0)
+	if (used == capacity)
+	{
+	    if (sized)
+		break;
+	    // file did not report its size
+	    capacity = capacity ? 2 * capacity : 4096;
+	    if (length >= 0 && (size_t) length < capacity)
+		capacity = length;
+	    data = buffer.resize (capacity);
+	}
+
+	ssize_t bytes_read = pread (fd, data + used, capacity - used, offset + used);
+	if (bytes_read < 0)
+	{
+	    if (errno == EINTR)
+		continue;
+	    if (errno != ESPIPE || offset != 0)
+		return errno;
+	    // not seekable, fall back to plain read
+	    bytes_read = read (fd, data + used, capacity - used);
+	    if (bytes_read < 0)
+		return errno;
+	}
+	if (bytes_read == 0)
 	    break;
-	buffer[bytes_read] = 0; // 0 terminate string
-	output += buffer;
+	used += bytes_read;
     }
-    close(fd);
+
+    buffer.resize (used);
     return 0;
 }
 
 
+/**
+ * Read (part of) a file to string
+ */
+static int read_file_to_string (const char* filename, string& output,
+				off_t offset = 0, long long length = -1)
+{
+    output.clear ();
+
+    int fd = open (filename, O_RDONLY);
+    if (fd < 0)
+    {
+	return errno;
+    }
+
+    StringReadBuffer buffer (output);
+    int ret = read_fd_range (fd, offset, length, buffer);
+    close (fd);
+    return ret;
+}
+
+
 /**
  *  Fills a ycp map with informations of a stat structure.
  */
@@ -198,6 +303,64 @@ stat2map (const struct stat& sb)
 }
 
 
+/**
+ * Add stat maps of the entries of the open directory dirfd to result,
+ * keyed by prefix + entry name. Takes ownership of dirfd.
+ * @param follow use stat instead of lstat semantics for the entries
+ * @param recursive descend into subdirectories (never into symlinks)
+ * @param pattern if not empty, report only entries matching the glob
+ */
+static void
+dir_stat (int dirfd, const string& prefix, bool follow, bool recursive,
+	  const string& pattern, YCPMap& result)
+{
+    DIR *dir = fdopendir (dirfd);
+    if (!dir)
+    {
+	close (dirfd);
+	return;
+    }
+
+    const int flags = follow ? 0 : AT_SYMLINK_NOFOLLOW;
+
+    struct dirent *entry;
+    while ((entry = readdir (dir)))
+    {
+	if (!return_one (entry))
+	    continue;
+
+	const string name = prefix + entry->d_name;
+
+	if (pattern.empty () || fnmatch (pattern.c_str (), entry->d_name, 0) == 0)
+	{
+	    struct stat sb;
+	    if (fstatat (dirfd, entry->d_name, &sb, flags) == 0)
+		result->add (YCPString (name), stat2map (sb));
+	}
+
+	if (!recursive)
+	    continue;
+
+	bool isdir = entry->d_type == DT_DIR;
+	if (entry->d_type == DT_UNKNOWN)
+	{
+	    struct stat sb;
+	    isdir = fstatat (dirfd, entry->d_name, &sb, AT_SYMLINK_NOFOLLOW) == 0
+		&& S_ISDIR (sb.st_mode);
+	}
+
+	if (isdir)
+	{
+	    int subfd = openat (dirfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+	    if (subfd >= 0)
+		dir_stat (subfd, name + "/", follow, recursive, pattern, result);
+	}
+    }
+
+    closedir (dir);
+}
+
+
 /**
  * Run shell command and returns its output.
  */
@@ -301,7 +464,7 @@ dump_value (int level, const YCPValue& value)
  * Read function
  */
 YCPValue
-SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
+SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue& opt)
 {
     y2debug ("Read (%s)", path->toString().c_str());
 
@@ -345,6 +508,10 @@ SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
 
     string filename;
 
+    // byte range for .string and .byte, length -1 means up to the end
+    long long offset = 0;
+    long long length = -1;
+
     if (arg->isString())
     {
 	filename = arg->asString()->value();
@@ -356,6 +523,23 @@ SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
 	default_value = arg->asList()->value(1);
 	filename = arg->asList()->value(0)->asString()->value();
     }
+    else if (arg->isList()
+	     && (arg->asList()->size() == 3)
+	     && (arg->asList()->value(0)->isString())
+	     && (arg->asList()->value(1)->isInteger())
+	     && (arg->asList()->value(2)->isInteger())
+	     && (cmd == "string" || cmd == "byte"))
+    {
+	filename = arg->asList()->value(0)->asString()->value();
+	offset = arg->asList()->value(1)->asInteger()->value();
+	length = arg->asList()->value(2)->asInteger()->value();
+	if (offset < 0)
+	{
+	    ycp2error ("Negative offset for Read (.%s, [ string filename, integer offset, integer length ])",
+		       cmd.c_str ());
+	    return YCPNull ();
+	}
+    }
     else
     {
 	y2error ("Read (%s, %s) failed !", cmd.c_str(), arg->toString().c_str());
@@ -371,17 +555,22 @@ SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
     {
 	/**
 	 * @builtin Read (.target.string, string filename) -> string
+	 * @builtin Read (.target.string, [string filename, integer offset, integer length]) -> string
 	 * Opens an Ascii file and reads the contents to a single
 	 * string. Newlines are preserved.
 	 *
+	 * With the second form only length bytes starting at offset are
+	 * read. A negative length reads up to the end of the file.
+	 *
 	 * @example Read (.target.string, "/some/file") -> "a contents"
+	 * @example Read (.target.string, ["/some/file", 2, 3]) -> "con"
 	 */
 
 	string output;
-	int ret = read_file_to_string (filename.c_str (), output);
+	int ret = read_file_to_string (filename.c_str (), output, offset, length);
 	if (ret == 0)
 	{
-	    return YCPString (output);
+	    return YCPString (std::move (output));
 	}
 	else if (!default_value.isNull())
 	{
@@ -398,7 +587,11 @@ SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
     {
 	/**
 	 * @builtin Read (.target.byte, string filename) -> byteblock
+	 * @builtin Read (.target.byte, [string filename, integer offset, integer length]) -> byteblock
 	 * Opens a binary file and reads its contents into a single byteblock.
+	 *
+	 * With the second form only length bytes starting at offset are
+	 * read. A negative length reads up to the end of the file.
 	 */
 
 	int fd = open (filename.c_str (), O_RDONLY);
@@ -415,35 +608,19 @@ SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
 	    }
 	}
 
-	// determine filesize
-	struct stat sb;
-	fstat (fd, &sb);
-	size_t filesize = sb.st_size;
-
-	// don't try to allocate this on the stack
-	unsigned char *buffer = (unsigned char *) malloc (filesize);
-
-	if (!buffer)
-	{
-	    close (fd);
-	    return YCPError (string ("Read (.byte, \"") + filename +
-			     "\") failed: " + strerror (errno));
-	}
+	ByteReadBuffer buffer;
+	int ret = read_fd_range (fd, offset, length, buffer);
+	close (fd);
 
-	size_t read_bytes = read (fd, buffer, filesize);
-	if (read_bytes != filesize)
+	if (ret != 0)
 	{
-	    free (buffer);
-	    close (fd);
 	    return YCPError (string ("Read (.byte, \"") +
 			     filename + "\") failed: " +
-			     strerror (errno));
+			     strerror (ret));
 	}
 
-	YCPByteblock ret = YCPByteblock (buffer, filesize);
-	free (buffer);
-	close (fd);
-	return ret;
+	long size = buffer.size;
+	return YCPByteblock (buffer.release (), size, true);
     }
 
     else if (cmd == "ycp" || cmd == "yast2")
@@ -542,6 +719,56 @@ SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
 	return !contents.isNull() ? contents : YCPVoid();
     }
 
+    else if (cmd == "ybin")
+    {
+	/**
+	 * @builtin Read (.target.ybin, string filename) -> any
+	 * @builtin Read (.target.ybin, [string filename, any default]) -> any
+	 * Reads a value written by Write (.target.ybin, ...). Much faster
+	 * than .target.ycp for large values, the file is mapped and
+	 * decoded without parsing.
+	 * Returns default, if the file doesn't exist, is not readable,
+	 * was written by an incompatible version or is damaged. A warning
+	 * in the log is omitted if a default value is given.
+	 */
+
+	int fd = open (filename.c_str (), O_RDONLY);
+	if (fd < 0)
+	{
+	    if (!default_value.isNull())
+	    {
+		return default_value;
+	    }
+	    return YCPError ("Open file '" + filename + "' failed: " + strerror (errno));
+	}
+
+	struct stat st;
+	void *data = MAP_FAILED;
+	if (fstat (fd, &st) == 0 && st.st_size > 0)
+	{
+	    data = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close (fd);
+
+	YCPValue contents = YCPNull ();
+	if (data != MAP_FAILED)
+	{
+	    madvise (data, st.st_size, MADV_SEQUENTIAL);
+	    contents = Bytecode::readValueImage ((const char *) data, st.st_size, filename);
+	    munmap (data, st.st_size);
+	}
+
+	if (contents.isNull ())
+	{
+	    if (!default_value.isNull())
+	    {
+		return default_value;
+	    }
+	    return YCPError ("Reading value file '" + filename + "' failed");
+	}
+	return contents;
+    }
+
     else if (cmd == "dir")
     {
 	/**
@@ -582,6 +809,66 @@ SystemAgent::Read (const YCPPath& path, const YCPValue& arg, const YCPValue&)
 	return dirlist;
     }
 
+    else if (cmd == "dir_stat")
+    {
+	/**
+	 * @builtin Read (.target.dir_stat, string path) -> map
+	 * @builtin Read (.target.dir_stat, string path, map options) -> map
+	 * @builtin Read (.target.dir_stat, [string path, map default]) -> map
+	 * Reads a directory and the file information of all its entries
+	 * in one call. Returns a map from the file name to a map as
+	 * returned by Read (.target.stat). The entries '.' and '..' are
+	 * NOT returned. Returns nil, if path does not point to a readable
+	 * directory, or the default value if given.
+	 *
+	 * The options map may contain:
+	 * "recursive" (boolean) - also scan all subdirectories, the keys
+	 * are then paths relative to path. Symlinks to directories are
+	 * not followed. Default is false.
+	 * "glob" (string) - only return entries whose name matches the
+	 * pattern (see fnmatch(3)). Subdirectories are still scanned.
+	 * "lstat" (boolean) - do not follow symlinks, like
+	 * Read (.target.lstat). Default is false.
+	 *
+	 * @example Read (.target.dir_stat, "/etc/sysconfig") -> $[ "network" : $[ "isdir" : true, ... ], ... ]
+	 * @example Read (.target.dir_stat, "/lib/modules", $[ "recursive" : true, "glob" : "*.ko" ]) -> $[ ... ]
+	 */
+
+	bool recursive = false;
+	bool follow = true;
+	string pattern;
+
+	if (!opt.isNull() && opt->isMap())
+	{
+	    YCPMap options = opt->asMap();
+	    YCPValue v = options->value (YCPString ("recursive"));
+	    if (!v.isNull() && v->isBoolean())
+		recursive = v->asBoolean()->value();
+	    v = options->value (YCPString ("lstat"));
+	    if (!v.isNull() && v->isBoolean())
+		follow = !v->asBoolean()->value();
+	    v = options->value (YCPString ("glob"));
+	    if (!v.isNull() && v->isString())
+		pattern = v->asString()->value();
+	}
+
+	int dirfd = open (filename.c_str(), O_RDONLY | O_DIRECTORY);
+	if (dirfd < 0)
+	{
+	    if (!default_value.isNull())
+	    {
+		return default_value;
+	    }
+	    y2milestone ("Can't access directory '%s': %s'"
+		, filename.c_str (), strerror (errno));
+	    return YCPVoid ();
+	}
+
+	YCPMap result;
+	dir_stat (dirfd, "", follow, recursive, pattern, result);
+	return result;
+    }
+
     else if (cmd == "size")
     {
 	/**
@@ -818,7 +1105,7 @@ SystemAgent::Write (const YCPPath& path, const YCPValue& value,
 	return YCPBoolean (false);
     }
 
-    else if (cmd == "ycp" || cmd == "yast2")
+    else if (cmd == "ycp" || cmd == "yast2" || cmd == "ybin")
     {
 	/**
 	 * @builtin Write (.target.ycp, string filename, any value) -> boolean
@@ -838,6 +1125,15 @@ SystemAgent::Write (const YCPPath& path, const YCPValue& value,
 	 * pathname <tt>filename</tt> is created automatically.
 	 */
 
+	/**
+	 * @builtin Write (.target.ybin, string filename, any value) -> boolean
+	 * @builtin Write (.target.ybin, [ string filename, integer mode], any value) -> boolean
+	 * Like Write (.target.ycp, ...), but stores the value in a binary
+	 * format to be read by Read (.target.ybin, ...). The file carries
+	 * a version and a checksum. Values containing code or references
+	 * cannot be written.
+	 */
+
 	// either string or list
 
 	if (value.isNull() || !(value->isString() || value->isList()))
@@ -892,6 +1188,19 @@ SystemAgent::Write (const YCPPath& path, const YCPValue& value,
 	    return YCPBoolean (false);
 	}
 
+	if (cmd == "ybin")
+	{
+	    std::ostringstream image;
+	    if (Bytecode::writeValueImage (image, arg.isNull() ? YCPVoid() : arg))
+	    {
+		string contents = image.str();
+		ssize_t size = contents.length();
+		success = (size == write(fd, contents.data(), size));
+	    }
+	    close(fd);
+	    return YCPBoolean(success);
+	}
+
 	// string contents = (arg.isNull() ? "" : arg->toString());
 	string contents = (arg.isNull() ? "" : dump_value(0, arg));
 	ssize_t size = contents.length();
@@ -0,0 +1,51 @@
+#!/bin/sh
+# A .scr compiled by ycpc -c is mounted from the .ybc only while that
+# is strictly newer than the .scr. Compile one version of a .scr, put
+# another one in its place and check which of them y2base mounts.
+YCPC=../tools/ycpc/ycpc
+SCR=tmp.scr_compiled.scr
+rm -f $SCR $SCR.ybc
+
+# write $SCR reading the given file below data
+description ()
+{
+    cat > $SCR <<EOF
+.tested
+
+\`ag_anyagent(
+  \`Description (
+    \`File ("$(pwd)/data/$1"),
+    "#\n",
+    true,
+    \`List (\`String ("^ \n"), " ")
+  )
+)
+EOF
+}
+
+run ()
+{
+    SCR_COMPILED_EXPECTED="$1" ./y2base.sh scr_compiled.ycp \
+	|| { echo "$2"; cat scr_compiled.log; exit 1; }
+}
+
+description toplevel/target_root
+$YCPC -c -q -l /dev/null $SCR || exit 1
+[ -f $SCR.ybc ] || { echo "ycpc wrote no $SCR.ybc"; exit 1; }
+
+# the .scr now reads another file, the times are all within one
+# second and only the nanoseconds tell which file is newer
+description scr_compiled
+export SCR_COMPILED_EXPECTED
+touch -d "2020-01-01 12:00:00.500000000" $SCR.ybc
+
+touch -d "2020-01-01 12:00:00.300000000" $SCR
+run '["BOOT_IMAGE=fbdev", "ro", "root=801"]' "the newer .ybc was not used"
+
+touch -d "2020-01-01 12:00:00.700000000" $SCR
+run '["root=802", "ro"]' "the newer .scr did not win"
+
+touch -d "2020-01-01 12:00:00.500000000" $SCR
+run '["root=802", "ro"]' "a .ybc as old as the .scr was used"
+
+rm -f $SCR $SCR.ybc
@@ -25,6 +25,7 @@
 #include <ycp/Bytecode.h>
 #include <ycp/Xmlcode.h>
 #include <ycp/Import.h>
+#include <ycp/Profiler.h>
 #include <ycp/y2log.h>
 #include <../../libycp/src/parser.hh>
 #include <ycp/pathsearch.h>
@@ -61,6 +62,7 @@ static int freshen = 0;		// freshen recompilation
 static int force = 0;		// force recompilation
 static int no_implicit_namespaces = 0;	// don't preload implicit namespaces
 static const char *ui_name = 0;
+static const char *profile_name = 0;	// sample -r runs to this file
 #define UI_QT_NAME "qt"
 #define UI_NCURSES_NAME "ncurses"
 
@@ -815,6 +817,16 @@ recompileAll (const std::list<std::string> & deplist, const char *depend)
 //-----------------------------------------------------------------------------
 
 
+/**
+ * Does the name denote a .scr agent definition?
+ */
+static bool
+is_scr (const char *name)
+{
+    size_t len = strlen (name);
+    return len > 4 && strcmp (name + len - 4, ".scr") == 0;
+}
+
 /**
  * parse file and return corresponding YCode or NULL for error
  * "-" is stdin
@@ -857,6 +869,15 @@ parsefile (const char *infname)
 
     progress ("parsing '%s'\n", infname);
 
+    if (is_scr (infname))
+    {
+	// like SCRAgent::readconf, skip everything upto (including)
+	// the line with the mount path
+	char line[250];
+	while (fgets (line, sizeof (line), infile) && line[0] != '.')
+	    ;
+    }
+
     parser->setInput (infile, infname);
     parser->setBuffered();
 
@@ -892,7 +913,8 @@ parsefile (const char *infname)
 /**
  * Compile one file
  * infname: "-" is stdin
- * outfname: if NULL it is created from infname by replacing .ycp by .ybc
+ * outfname: if NULL it is created from infname by replacing .ycp by .ybc,
+ *   .scr files get .ybc appended (see SCRAgent::readconf)
  * return:
  * 0 - success
  * 1 - writing failed
@@ -924,6 +946,12 @@ compilefile (const char *infname, const char *outfname)
 
     YCodePtr c = parsefile (infname);
 
+    if (c != NULL && is_scr (infname) && c->kind () != YCode::yeTerm)
+    {
+	fprintf (stderr, "Not a term in scr file '%s'\n", infname);
+	return 2;
+    }
+
     if (c != NULL )
     {
 	progress ("saving ...\n");
@@ -934,6 +962,8 @@ compilefile (const char *infname, const char *outfname)
 	else {
 	    result = Bytecode::writeFile (c, ofname);
 	}
+	// the new file may be imported right away
+	YCPPathSearch::expireSnapshots ();
 	return result ? 0 : 1;
     }
 
@@ -1074,7 +1104,8 @@ recurse (const char *path)
 	handle = next;
 
 	extpos = handle->length + strlen (handle->path + handle->length) - 4;
-	if (strcmp (handle->path + extpos, ".ycp") == 0)
+	if (strcmp (handle->path + extpos, ".ycp") == 0
+	    || (compile && is_scr (handle->path)))
 	{
 	    if (processfile (handle->path, NULL))
 		ret = 1;
@@ -1103,7 +1134,7 @@ void print_help (const char *name)
     printf ("  %s [-v] [--version]\n", name);
     printf ("  %s <command> [<option>]... <filename>...\n", name);
     printf ("  %s\n", "Commands:");
-    printf (opt_fmt, "-c, --compile", "compile to bytecode");
+    printf (opt_fmt, "-c, --compile", "compile to bytecode (.ycp and .scr)");
     printf (opt_fmt, "-E, --fsyntax-only", "check syntax and print (unless -q)");
     printf (opt_fmt, "-f, --freshen", "freshen .ybc files");
     printf (opt_fmt, "-p, --print", "read and print bytecode");
@@ -1124,6 +1155,7 @@ void print_help (const char *name)
     printf (opt_fmt, "-o, --output", "output file for -c, -E, -p, -r");
     printf (opt_fmt, "-R, --recursive", "operate recursively");
     printf (opt_fmt, "-u, --ui {ncurses|qt}", "UI to start in combination with 'r'");
+    printf (opt_fmt, "--profile <name>", "for -r, write folded stack samples to <name>");
 //    printf (opt_fmt, "-, --", "");
 #undef opt_fmt
 }
@@ -1178,6 +1210,7 @@ int main(int argc, char *argv[])
 	    {"no-std-paths", 0, 0, 'n'},		// no standard pathes
 	    {"output", 1, 0, 'o'},			// output file
 	    {"print", 0, 0, 'p'},			// read & print bytecode
+	    {"profile", 1, 0, 259},			// sample -r runs
 	    {"run", 0, 0, 'r'},				// read & run bytecode
 	    {"quiet", 0, 0, 'q'},			// no output
 	    {"recursive", 0, 0, 'R'},			// recursively
@@ -1199,6 +1232,9 @@ int main(int argc, char *argv[])
 	    case 258:
 		YCPPathSearch::clearPaths (YCPPathSearch::Module);
 	    break;
+	    case 259:
+		profile_name = strdup (optarg);
+	    break;
 	    case 'h':
 	    case '?':
 		print_help ("ycpc");
@@ -1305,6 +1341,10 @@ int main(int argc, char *argv[])
 	YCPPathSearch::addPath (YCPPathSearch::Module, pathit->c_str());
     }
 
+    // the search directories hardly change during a compilation,
+    // look them up in memory instead of probing each of them
+    YCPPathSearch::setSnapshots (true);
+
     // register builtins
     SCR scr;
     WFM wfm;
@@ -1339,6 +1379,14 @@ int main(int argc, char *argv[])
 	}
     }
 
+    if (read_n_run
+	&& profile_name != 0
+	&& !YaST::Profiler::start (profile_name))
+    {
+	fprintf (stderr, "Can't profile to %s\n", profile_name);
+	exit (1);
+    }
+
     std::list <FileDep> deplist;
 
     for (i = optind; i < argc;i++)
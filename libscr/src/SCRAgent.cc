@@ -17,6 +17,8 @@
 
 /-*/
 
+#include <sys/stat.h>
+
 #include <ycp/y2log.h>
 
 #include "include/scr/SCRAgent.h"
@@ -24,6 +26,7 @@
 
 #include "ycp/Parser.h"
 #include "ycp/YCode.h"
+#include "ycp/Bytecode.h"
 
 SCRAgent* SCRAgent::current_scr = 0;
 
@@ -70,9 +73,48 @@ SCRAgent::otherCommand (const YCPTerm&)
 }
 
 
+/**
+ * Read the term precompiled by ycpc. Returns 0 if there is no
+ * usable compiled file.
+ */
+static YCodePtr
+readcompiledconf (const char *filename)
+{
+    const string compiled = string (filename) + ".ybc";
+
+    // the .ybc must be strictly newer, within the same second only
+    // the nanoseconds tell which file was written last
+    struct stat src, bin;
+    if (stat (compiled.c_str (), &bin) != 0
+	|| stat (filename, &src) != 0
+	|| bin.st_mtim.tv_sec < src.st_mtim.tv_sec
+	|| (bin.st_mtim.tv_sec == src.st_mtim.tv_sec
+	    && bin.st_mtim.tv_nsec <= src.st_mtim.tv_nsec))
+    {
+	return 0;
+    }
+
+    YCodePtr code = Bytecode::readFile (compiled);
+    if (code == 0 || code->kind () != YCode::yeTerm)
+    {
+	y2warning ("Ignoring invalid compiled scr file %s", compiled.c_str ());
+	return 0;
+    }
+
+    y2debug ("Using compiled scr file %s", compiled.c_str ());
+    return code;
+}
+
+
 YCPValue
 SCRAgent::readconf (const char *filename)
 {
+    YCodePtr compiled = readcompiledconf (filename);
+    if (compiled != 0)
+    {
+	return compiled->evaluate ();
+    }
+
     FILE *file = fopen (filename, "r");
     if (!file)
     {
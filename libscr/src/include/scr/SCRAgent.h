@@ -146,6 +146,10 @@ public:
      * Reads the scr config file and returns the term. It skips all lines
      * upto (including) the first starting with a ".", which is the path
      * where the agant gets mounted (by the ScriptingAgent).
+     *
+     * If a precompiled "filename.ybc" (see ycpc -c) exists and is not
+     * older than the file itself, the term is read from it instead of
+     * parsing the file.
      */
     static YCPValue readconf (const char *filename);
     
@@ -35,6 +35,7 @@ bool Y2ComponentBroker::stop_register = false;
 
 map<const char*, const Y2Component*, Y2ComponentBroker::ltstr> Y2ComponentBroker::namespaces;
 map<string, string> Y2ComponentBroker::namespace_exceptions;
+map<string, Y2ComponentBroker::namespace_lookup_t> Y2ComponentBroker::namespace_lookups;
 
 
 void Y2ComponentBroker::registerComponentCreator(const Y2ComponentCreator *c, order_t order, bool force)
@@ -54,6 +55,11 @@ void Y2ComponentBroker::registerComponentCreator(const Y2ComponentCreator *c, or
     {
 	// y2debug( "Registering component creator at %p - force: %d", c, (int) force );
         creators[order]->push_back(c);
+
+	// lookups can only have been cached after registration was closed;
+	// before that the map may not even be constructed yet
+	if (stop_register)
+	    flushNamespaceLookups ();
     }
 }
 
@@ -153,6 +159,33 @@ Y2ComponentBroker::getNamespaceComponent (const char* name)
     }
 
 
+    unsigned long generation = namespaceGeneration ();
+
+    map<string, namespace_lookup_t>::iterator li = namespace_lookups.find (name);
+    if (li != namespace_lookups.end ())
+    {
+	if (li->second.generation != generation)
+	{
+	    namespace_lookups.erase (li);
+	}
+	else if (li->second.creator == 0)
+	{
+	    y2debug ("namespace %s is known to be missing", name);
+	    return 0;
+	}
+	else
+	{
+	    Y2ComponentCreator *creator = const_cast<Y2ComponentCreator *> (li->second.creator);
+	    Y2Component *component = creator->provideNamespace (name);
+	    if (component)
+	    {
+		y2debug ("Component %p used for namespace %s (cached creator)", component, name);
+		return component;
+	    }
+	    namespace_lookups.erase (li);
+	}
+    }
+
 // uselessly repeats if it failed
 //    for (int level = 0; level < Y2PathSearch::numberOfComponentLevels ();
 //	 level++)
@@ -171,12 +204,17 @@ Y2ComponentBroker::getNamespaceComponent (const char* name)
 		{
 		    // FIXME: Y2PathSearch::GENERIC is not correct (must depend on order)
 		    y2debug ("Component %p used for namespace %s", component, name);
+		    namespace_lookup_t found = { ccreator, generation };
+		    namespace_lookups[name] = found;
 		    return component;
 		}
 	    }
 	}
     }
 
+    namespace_lookup_t missing = { 0, generation };
+    namespace_lookups[name] = missing;
+
     return 0;
 }
 
@@ -191,11 +229,34 @@ bool Y2ComponentBroker::registerNamespaceException(const char* name_space, const
     }
 
     namespace_exceptions.insert ( std::pair<string,string>(name_space,component_name) );
+    flushNamespaceLookups ();
 
     return true;
 }
 
 
+void Y2ComponentBroker::flushNamespaceLookups ()
+{
+    namespace_lookups.clear ();
+}
+
+
+unsigned long
+Y2ComponentBroker::namespaceGeneration ()
+{
+    // make sure the module directories are watched; the plugin
+    // directories are registered by Y2PathSearch::findy2plugin
+    YCPPathSearch::initialize ();
+    for (std::list<string>::const_iterator it = YCPPathSearch::searchListBegin (YCPPathSearch::Module);
+	 it != YCPPathSearch::searchListEnd (YCPPathSearch::Module); ++it)
+    {
+	Y2PathSearch::snapshot (*it);
+    }
+
+    return Y2PathSearch::snapshotGeneration ();
+}
+
+
 void Y2ComponentBroker::initializeLists ()
 {
     if (creators[0] == 0) {
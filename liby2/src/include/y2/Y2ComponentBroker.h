@@ -132,7 +132,26 @@ private:
      * namespace to be created by a preffered component.
      */
     static map<string, string> namespace_exceptions;
-    
+
+    /**
+     * Result of an earlier namespace lookup: the creator that provided
+     * the namespace, or 0 if none did. It is only trusted while the
+     * search directories have not changed since (see generation).
+     */
+    struct namespace_lookup_t
+    {
+	const Y2ComponentCreator *creator;
+	unsigned long generation;
+    };
+
+    static map<string, namespace_lookup_t> namespace_lookups;
+
+    /**
+     * Returns the current generation of the directories that namespaces
+     * are searched in.
+     */
+    static unsigned long namespaceGeneration ();
+
 public:
     /**
      * Enters a component creator into the list of
@@ -191,6 +210,13 @@ public:
      */
     static bool registerNamespaceException(const char* name_space, const char* component_name);
 
+    /**
+     * Forget which creators provided (or failed to provide) namespaces.
+     * Done automatically when a creator registers or the module and plugin
+     * directories change.
+     */
+    static void flushNamespaceLookups();
+
 private:
     /**
      * Initializes @ref #creators.
@@ -0,0 +1,127 @@
+/*---------------------------------------------------------------------\
+|                                                                      |
+|                      __   __    ____ _____ ____                      |
+|                      \ \ / /_ _/ ___|_   _|___ \                     |
+|                       \ V / _` \___ \ | |   __) |                    |
+|                        | | (_| |___) || |  / __/                     |
+|                        |_|\__,_|____/ |_| |_____|                    |
+|                                                                      |
+|                               core system                            |
+|                                                    (C) SUSE LINUX AG |
+\----------------------------------------------------------------------/
+
+   File:       MemPool.cc
+
+/-*/
+
+#include "y2util/MemPool.h"
+#include <stdlib.h>
+#include <cstdio>
+#include <new>
+
+// zero initialized before any constructor runs, objects
+// created during static initialization may use the pool
+MemPool::sizeclass_t MemPool::s_classes[CLASSES];
+int MemPool::s_enabled = -1;
+
+
+bool
+MemPool::enabled ()
+{
+    if (s_enabled < 0)
+    {
+	s_enabled = (getenv ("Y2NOMEMPOOL") == 0);
+	if (s_enabled && getenv ("Y2MEMPOOLDUMP") != 0)
+	{
+	    atexit (dump);
+	}
+    }
+    return s_enabled;
+}
+
+
+void *
+MemPool::refill (sizeclass_t &c, std::size_t blocksize)
+{
+    if (c.next + blocksize > c.end)
+    {
+	// the rest of the old chunk is too small for a block, leave it
+	c.next = static_cast<char *> (::operator new (CHUNK_SIZE));
+	c.end = c.next + CHUNK_SIZE;
+    }
+    void *p = c.next;
+    c.next += blocksize;
+    c.total++;
+    return p;
+}
+
+
+void *
+MemPool::allocate (std::size_t size)
+{
+    if (size == 0 || size > MAX_SIZE || !enabled ())
+    {
+	return ::operator new (size);
+    }
+
+    std::size_t index = (size - 1) / GRANULE;
+    sizeclass_t &c = s_classes[index];
+    c.used++;
+    c.allocs++;
+
+    block_t *b = c.free;
+    if (b)
+    {
+	c.free = b->next;
+	return b;
+    }
+    return refill (c, (index + 1) * GRANULE);
+}
+
+
+void
+MemPool::release (void *p, std::size_t size)
+{
+    if (p == 0)
+    {
+	return;
+    }
+    if (size == 0 || size > MAX_SIZE || !enabled ())
+    {
+	::operator delete (p);
+	return;
+    }
+
+    sizeclass_t &c = s_classes[(size - 1) / GRANULE];
+    c.used--;
+
+    block_t *b = static_cast<block_t *> (p);
+    b->next = c.free;
+    c.free = b;
+}
+
+
+void
+MemPool::dump ()
+{
+    if (!enabled ())
+    {
+	fprintf (stderr, "MemPool disabled\n");
+	return;
+    }
+
+    fprintf (stderr, "MemPool dump:\n");
+    unsigned long used = 0, total = 0, allocs = 0;
+    for (int i = 0; i < CLASSES; ++i)
+    {
+	const sizeclass_t &c = s_classes[i];
+	if (c.total == 0)
+	    continue;
+	unsigned long size = (i + 1) * GRANULE;
+	used += c.used * size;
+	total += c.total * size;
+	allocs += c.allocs;
+	fprintf (stderr, "%9lu/%9lu <%5lu> [%9lu] %9lu allocations\n", c.used, c.total, size, c.used * size, c.allocs);
+    }
+    fprintf (stderr, "%9lu of %lu pooled bytes in use, %lu allocations\n", used, total, allocs);
+}
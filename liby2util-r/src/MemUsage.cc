@@ -18,6 +18,7 @@ $Id$
 /-*/
 
 #include "y2util/MemUsage.h"
+#include "y2util/MemPool.h"
 #include <stdlib.h>
 #include <map>
 #include <string>
@@ -74,6 +75,7 @@ void MemUsage::MuDump ()
     }
     fprintf (stderr, "%9lu Total bytes\n", sum);
 
+    MemPool::dump ();
 }
 
 // for gdb copy and paste convenience
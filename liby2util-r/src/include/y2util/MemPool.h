@@ -0,0 +1,79 @@
+/*-----------------------------------------------------------*- c++ -*-\
+|                                                                      |
+|                      __   __    ____ _____ ____                      |
+|                      \ \ / /_ _/ ___|_   _|___ \                     |
+|                       \ V / _` \___ \ | |   __) |                    |
+|                        | | (_| |___) || |  / __/                     |
+|                        |_|\__,_|____/ |_| |_____|                    |
+|                                                                      |
+|                               core system                            |
+|                                                    (C) SUSE LINUX AG |
+\----------------------------------------------------------------------/
+
+   File:       MemPool.h
+
+/-*/
+
+#ifndef MemPool_h
+#define MemPool_h
+
+#include <cstddef>
+
+
+/**
+ * Size class pool for small objects
+ *
+ * Value reps and code nodes are small, numerous and short lived.
+ * MemPool hands out blocks of up to MAX_SIZE bytes from free lists,
+ * one list per size class of GRANULE bytes, carved from CHUNK_SIZE
+ * chunks. Freed blocks go back to their list, chunks are never
+ * returned.
+ *
+ * A class uses the pool by defining
+ * <pre>
+ *   static void *operator new (size_t size) { return MemPool::allocate (size); }
+ *   static void operator delete (void *p, size_t size) { MemPool::release (p, size); }
+ * </pre>
+ * Larger sizes are passed to the global operators.
+ *
+ * Setting Y2NOMEMPOOL in the environment makes all requests go to
+ * the global operators, for valgrind and the like. Setting
+ * Y2MEMPOOLDUMP prints the usage at exit.
+ */
+class MemPool
+{
+public:
+    enum {
+	GRANULE = 8,
+	MAX_SIZE = 256,
+	CLASSES = MAX_SIZE / GRANULE,
+	CHUNK_SIZE = 64 * 1024
+    };
+
+    static void *allocate (std::size_t size);
+    static void release (void *p, std::size_t size);
+
+    //! print the usage per size class to stderr
+    static void dump ();
+
+private:
+    struct block_t { block_t *next; };
+
+    struct sizeclass_t
+    {
+	block_t *free;		// free list
+	char *next;		// unused rest of the current chunk
+	char *end;
+	unsigned long used;	// blocks handed out
+	unsigned long total;	// blocks ever carved
+	unsigned long allocs;	// allocate calls
+    };
+
+    static sizeclass_t s_classes[CLASSES];
+    static int s_enabled;
+
+    static bool enabled ();
+    static void *refill (sizeclass_t &c, std::size_t blocksize);
+};
+
+#endif
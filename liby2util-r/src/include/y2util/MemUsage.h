@@ -52,7 +52,8 @@ protected:
 	m_mu_instances->erase (this);
     }
 public:
-    //! dump all classes and nuber of their instances
+    //! dump all classes and nuber of their instances,
+    //  followed by the MemPool usage
     static void MuDump ();
     //! for a given class, dump its instances' addresses,
     //  ready to be printed in gdb
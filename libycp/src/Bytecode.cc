@@ -25,9 +25,14 @@
 // provide a backward compatibility
 #define YaST_BYTECODE_HEADER "YaST bytecode "
 #define YaST_BYTECODE_MAJOR "1"
-#define YaST_BYTECODE_MINOR "4"
+#define YaST_BYTECODE_MINOR "5"
 #define YaST_BYTECODE_RELEASE "0"
 
+#define WRITE_BUFFER_SIZE (64 * 1024)
+
+// value images use the value encoding of the same version
+#define YaST_YBIN_HEADER "YaST ybin "
+
 #include "ycp/Bytecode.h"
 #include "YCP.h"
 #include "ycp/YCode.h"
@@ -41,6 +46,8 @@
 #include "ycp/pathsearch.h"
 
 #include <fstream>
+#include <sstream>
+#include <unordered_map>
 #include <errno.h>
 #include <string.h>
 #include <ctype.h>
@@ -70,27 +77,46 @@ bytecodeistream::bytecodeistream (string filename)
     , m_major (-1)
     , m_minor (-1)
     , m_release (-1)
+    , m_compact (false)
 {
     if (!is_open ())
     {
 	y2error ("Failed to open '%s': %s", filename.c_str(), strerror (errno));
 	return;
     }
-    // read YaST_BYTECODE_HEADER
+    readHeader (YaST_BYTECODE_HEADER, filename);
+}
+
+
+bytecodeistream::bytecodeistream (std::streambuf * buf, const char * header, const string & name)
+    : std::ifstream ()
+    , m_major (-1)
+    , m_minor (-1)
+    , m_release (-1)
+    , m_compact (false)
+{
+    std::ios::rdbuf (buf);
+    readHeader (header, name);
+}
+
 
-    char header[sizeof(YaST_BYTECODE_HEADER)+1];
-    int headerlen = strlen (YaST_BYTECODE_HEADER);
+void
+bytecodeistream::readHeader (const char * expected, const string & name)
+{
+    char header[32];
+    int headerlen = strlen (expected);
     read (header, headerlen);
-    header[headerlen] = 0;
-    if (strcmp (header, YaST_BYTECODE_HEADER) != 0)
+    header[gcount ()] = 0;
+    if (strcmp (header, expected) != 0)
     {
-	y2error ("Not a bytecode file '%s'[%s]", filename.c_str(), header);
+	y2error ("Not a bytecode file '%s'[%s]", name.c_str(), header);
 	return;
     }
 
     m_major = readInt (*this);
     m_minor = readInt (*this);
     m_release = readInt (*this);
+    m_compact = (m_major > 1) || (m_major == 1 && m_minor >= 5);
 }
 
 bool bytecodeistream::isVersion (int major, int minor, int release)
@@ -145,6 +171,96 @@ Bytecode::namespaceInit ()
     Bytecode::m_namespace_tare_level = 0;
 }
 
+// ------------------------------------------------------------------
+// Since 1.5.0 ints are LEB128 varints. Strings and types are written
+// once per file, later occurrences refer to them by their index in the
+// pool. Each string or type starts with a code:
+
+enum {
+    POOL_NEW = 0,	// follows inline, append it to the pool
+    POOL_INLINE = 1,	// follows inline, not pooled
+    POOL_INDEX = 2	// code - POOL_INDEX is the pool index
+};
+
+// longer strings are rarely repeated
+#define POOL_MAX_STRING 256
+
+// attached to the output stream by writeFile and writeValueImage
+struct writepool_t
+{
+    std::unordered_map<string, u_int32_t> strings;
+    std::unordered_map<string, u_int32_t> types;
+};
+
+static int
+poolSlot ()
+{
+    static int slot = std::ios_base::xalloc ();
+    return slot;
+}
+
+static writepool_t *
+writePool (std::ostream & str)
+{
+    return static_cast<writepool_t *> (str.pword (poolSlot ()));
+}
+
+
+static std::ostream &
+writeChars (std::ostream & str, const char * chars, u_int32_t len)
+{
+    writepool_t *pool = writePool (str);
+    if (pool == 0 || len == 0 || len > POOL_MAX_STRING)
+    {
+	Bytecode::writeInt32 (str, POOL_INLINE);
+    }
+    else
+    {
+	std::pair<std::unordered_map<string, u_int32_t>::iterator, bool> res
+	    = pool->strings.insert (std::make_pair (string (chars, len), (u_int32_t) pool->strings.size ()));
+	if (!res.second)
+	{
+	    return Bytecode::writeInt32 (str, POOL_INDEX + res.first->second);
+	}
+	Bytecode::writeInt32 (str, POOL_NEW);
+    }
+    Bytecode::writeInt32 (str, len);
+    return str.write (chars, len);
+}
+
+
+// read a string of a compact stream, false on failure
+static bool
+readChars (bytecodeistream & str, string & value)
+{
+    u_int32_t code = Bytecode::readInt32 (str);
+    if (code >= POOL_INDEX)
+    {
+	const std::vector<string> & pool = str.stringPool ();
+	if (code - POOL_INDEX >= pool.size ())
+	{
+	    y2error ("Invalid string index %u", code - POOL_INDEX);
+	    throw Bytecode::Invalid ();
+	}
+	value = pool[code - POOL_INDEX];
+	return true;
+    }
+
+    u_int32_t len = Bytecode::readInt32 (str);
+    value.resize (len);
+    if (len > 0 && !str.read (&value[0], len))
+    {
+	value.erase ();
+	return false;
+    }
+    if (code == POOL_NEW)
+    {
+	str.stringPool ().push_back (value);
+    }
+    return true;
+}
+
+
 // ------------------------------------------------------------------
 // bool I/O
 
@@ -178,17 +294,41 @@ Bytecode::readBool (bytecodeistream & str)
 std::ostream &
 Bytecode::writeInt32 (std::ostream & str, const u_int32_t value)
 {
-    str.put ((char)4);
-    str.put ((char)(value & 0xff));
-    str.put ((char)(value>>8 & 0xff));
-    str.put ((char)(value>>16 & 0xff));
-    return str.put ((char)(value>>24 & 0xff));
+    u_int32_t v = value;
+    while (v >= 0x80)
+    {
+	str.put ((char)((v & 0x7f) | 0x80));
+	v >>= 7;
+    }
+    return str.put ((char)v);
 }
 
 
 u_int32_t
 Bytecode::readInt32 (bytecodeistream & str)
 {
+    if (str.isCompact ())
+    {
+	u_int32_t value = 0;
+	char c;
+	for (int shift = 0; shift < 35 && str.get (c); shift += 7)
+	{
+	    value |= (u_int32_t)(c & 0x7f) << shift;
+	    if ((c & 0x80) == 0)
+	    {
+		return value;
+	    }
+	}
+	if (str.good ())
+	{
+	    // a 32 bit value takes at most 5 bytes
+	    y2error ("Invalid integer encoding");
+	    throw Bytecode::Invalid ();
+	}
+	return 0;
+    }
+
+    // before 1.5.0: a length byte and 4 bytes little endian
 //    char c;
 //    str.get (c);
 //    if (c != 4)
@@ -219,16 +359,24 @@ Bytecode::readInt32 (bytecodeistream & str)
 std::ostream &
 Bytecode::writeString (std::ostream & streamref, const string & stringref)
 {
-    u_int32_t len = stringref.size();
-
-    writeInt32 (streamref, len);
-    return streamref.write (stringref.c_str(), len);
+    return writeChars (streamref, stringref.data (), stringref.size ());
 }
 
 
 bool
 Bytecode::readString (bytecodeistream & streamref, string & stringref)
 {
+    if (streamref.isCompact ())
+    {
+	if (!readChars (streamref, stringref))
+	{
+	    return false;
+	}
+	// like below, up to the first NUL
+	stringref.erase (strlen (stringref.c_str ()));
+	return !stringref.empty ();
+    }
+
     bool ret = false;
     stringref.erase();
     u_int32_t len = readInt32 (streamref);
@@ -253,16 +401,20 @@ Bytecode::readString (bytecodeistream & streamref, string & stringref)
 std::ostream &
 Bytecode::writeUstring (std::ostream & streamref, const Ustring ustringref)
 {
-    u_int32_t len = ustringref->size();
-
-    writeInt32 (streamref, len);
-    return streamref.write (ustringref->c_str(), len);
+    return writeChars (streamref, ustringref->c_str (), ustringref->size ());
 }
 
 
 Ustring
 Bytecode::readUstring (bytecodeistream & streamref)
 {
+    if (streamref.isCompact ())
+    {
+	string value;
+	readChars (streamref, value);
+	return Ustring (*SymbolEntry::_nameHash, value.c_str ());
+    }
+
     u_int32_t len = readInt32 (streamref);
     Ustring ret = Ustring (*SymbolEntry::_nameHash, "");
     if (len > 0)
@@ -284,15 +436,25 @@ Bytecode::readUstring (bytecodeistream & streamref)
 std::ostream &
 Bytecode::writeCharp (std::ostream & str, const char * charp)
 {
-    u_int32_t len = strlen (charp);
-    writeInt32 (str, len);
-    return str.write (charp, len);
+    return writeChars (str, charp, strlen (charp));
 }
 
 
 char *
 Bytecode::readCharp (bytecodeistream & str)
 {
+    if (str.isCompact ())
+    {
+	string value;
+	if (!readChars (str, value))
+	{
+	    return 0;
+	}
+	char *buf = new char [value.size () + 1];
+	memcpy (buf, value.c_str (), value.size () + 1);
+	return buf;
+    }
+
     u_int32_t len = readInt32 (str);
     if (str.good())
     {
@@ -342,12 +504,61 @@ Bytecode::readBytep (bytecodeistream & str)
 std::ostream &
 Bytecode::writeType (std::ostream & str, constTypePtr type)
 {
-    return type->toStream (str);
+    writepool_t *pool = writePool (str);
+    if (pool == 0)
+    {
+	writeInt32 (str, POOL_INLINE);
+	return type->toStream (str);
+    }
+
+    // the encoding is the key, subtypes are inline there
+    std::ostringstream encoded;
+    type->toStream (encoded);
+    string key = encoded.str ();
+
+    std::pair<std::unordered_map<string, u_int32_t>::iterator, bool> res
+	= pool->types.insert (std::make_pair (key, (u_int32_t) pool->types.size ()));
+    if (!res.second)
+    {
+	return writeInt32 (str, POOL_INDEX + res.first->second);
+    }
+    writeInt32 (str, POOL_NEW);
+    return str.write (key.data (), key.size ());
 }
 
 
 TypePtr
 Bytecode::readType (bytecodeistream & str)
+{
+    if (!str.isCompact ())
+    {
+	return readTypeBody (str);
+    }
+
+    u_int32_t code = readInt32 (str);
+    std::vector<TypePtr> & pool = str.typePool ();
+    if (code >= POOL_INDEX)
+    {
+	if (code - POOL_INDEX >= pool.size ())
+	{
+	    y2error ("Invalid type index %u", code - POOL_INDEX);
+	    throw Bytecode::Invalid ();
+	}
+	// the caller may modify it
+	return pool[code - POOL_INDEX]->clone ();
+    }
+
+    TypePtr type = readTypeBody (str);
+    if (code == POOL_NEW)
+    {
+	pool.push_back (type->clone ());
+    }
+    return type;
+}
+
+
+TypePtr
+Bytecode::readTypeBody (bytecodeistream & str)
 {
     int kind = readInt32 (str);
 #if DO_DEBUG
@@ -1125,6 +1336,157 @@ Bytecode::readModule (const string & mname)
 }
 
 
+// ------------------------------------------------------------------
+// value images
+
+// an istream over a piece of memory, e.g. a mapped file
+class memorybuf : public std::streambuf
+{
+public:
+    memorybuf (const char * data, size_t size)
+    {
+	char * p = const_cast<char *> (data);	// only read
+	setg (p, p, p + size);
+    }
+    size_t position () const { return gptr () - eback (); }
+};
+
+
+// Adler-32, see RFC 1950
+static u_int32_t
+checksum (const char * data, size_t size)
+{
+    const unsigned char * p = (const unsigned char *) data;
+    u_int32_t a = 1, b = 0;
+    while (size > 0)
+    {
+	// the largest n for which b cannot overflow
+	size_t n = size < 5552 ? size : 5552;
+	size -= n;
+	while (n-- > 0)
+	{
+	    a += *p++;
+	    b += a;
+	}
+	a %= 65521;
+	b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+
+// can the value be read back without any namespace context?
+static bool
+isPlainValue (const YCPValue & value)
+{
+    switch (value->valuetype ())
+    {
+	case YT_CODE:
+	case YT_REFERENCE:
+	case YT_EXTERNAL:
+	case YT_ENTRY:
+	case YT_ERROR:
+	    return false;
+	case YT_LIST:
+	{
+	    YCPList list = value->asList ();
+	    for (YCPList::const_iterator it = list->begin (); it != list->end (); ++it)
+	    {
+		if (!isPlainValue (*it))
+		    return false;
+	    }
+	    return true;
+	}
+	case YT_MAP:
+	{
+	    YCPMap map = value->asMap ();
+	    for (YCPMap::const_iterator it = map->begin (); it != map->end (); ++it)
+	    {
+		if (!isPlainValue (it->first) || !isPlainValue (it->second))
+		    return false;
+	    }
+	    return true;
+	}
+	case YT_TERM:
+	    return isPlainValue (value->asTerm ()->args ());
+	default:
+	    return true;
+    }
+}
+
+
+bool
+Bytecode::writeValueImage (std::ostream & str, const YCPValue value)
+{
+    if (value.isNull () || !isPlainValue (value))
+    {
+	y2error ("Cannot write %s as a value image", value.isNull () ? "nil" : value->toString ().c_str ());
+	return false;
+    }
+
+    std::ostringstream payload;
+    payload.imbue (std::locale::classic ());
+    writepool_t pool;
+    payload.pword (poolSlot ()) = &pool;
+    bool ok = ! writeValue (payload, value).fail ();
+    payload.pword (poolSlot ()) = 0;
+    if (!ok)
+    {
+	return false;
+    }
+    string data = payload.str ();
+
+    string header = string (YaST_YBIN_HEADER YaST_BYTECODE_MAJOR "." YaST_BYTECODE_MINOR "." YaST_BYTECODE_RELEASE);
+    str.write (header.c_str (), header.size () + 1);	// including trailing \0
+    writeInt32 (str, data.size ());
+    writeInt32 (str, checksum (data.data (), data.size ()));
+    str.write (data.data (), data.size ());
+
+    return ! str.fail ();
+}
+
+
+YCPValue
+Bytecode::readValueImage (const char * data, size_t size, const string & name)
+{
+    memorybuf buf (data, size);
+    bytecodeistream str (&buf, YaST_YBIN_HEADER, name);
+    if (!str.isVersion (atoi (YaST_BYTECODE_MAJOR), atoi (YaST_BYTECODE_MINOR), atoi (YaST_BYTECODE_RELEASE)))
+    {
+	y2error ("Unsupported version %d.%d.%d of '%s'", str.major (), str.minor (), str.release (), name.c_str ());
+	return YCPNull ();
+    }
+
+    u_int32_t length = readInt32 (str);
+    u_int32_t sum = readInt32 (str);
+    size_t start = buf.position ();
+    if (!str || start + length != size)
+    {
+	y2error ("Truncated value image '%s'", name.c_str ());
+	return YCPNull ();
+    }
+    if (checksum (data + start, length) != sum)
+    {
+	y2error ("Checksum mismatch in value image '%s'", name.c_str ());
+	return YCPNull ();
+    }
+
+    try
+    {
+	YCPValue value = readValue (str);
+	if (!value.isNull () && str && buf.position () == size)
+	{
+	    return value;
+	}
+    }
+    catch (const Bytecode::Invalid&)
+    {
+    }
+    y2error ("Invalid value image '%s'", name.c_str ());
+    return YCPNull ();
+}
+
+
 // read YCode from file, return YCode (0 in case of failure)
 YCodePtr
 Bytecode::readFile (const string & filename)
@@ -1145,6 +1507,8 @@ Bytecode::readFile (const string & filename)
 	    , atoi (YaST_BYTECODE_MINOR)
 	    , atoi (YaST_BYTECODE_RELEASE))
 	||
+	instream.isVersion (1,4,0)	// before the compact format
+	||
 	instream.isVersion (1,3,2) )	// 9.1/SLES9
     {
 #if DO_DEBUG
@@ -1181,7 +1545,11 @@ Bytecode::writeFile (const YCodePtr code, const string & filename)
 #if DO_DEBUG
 //    y2debug ("Bytecode::writeFile (%s)", filename.c_str());
 #endif
-    std::ofstream outstream (filename.c_str());
+    // the code is written in many small pieces
+    std::vector<char> buffer (WRITE_BUFFER_SIZE);
+    std::ofstream outstream;
+    outstream.rdbuf ()->pubsetbuf (&buffer[0], buffer.size ());
+    outstream.open (filename.c_str());
     if (!outstream.is_open ())
     {
 	y2error ("Failed to write '%s': %s", filename.c_str(), strerror (errno));
@@ -1194,7 +1562,11 @@ Bytecode::writeFile (const YCodePtr code, const string & filename)
     string header =  string (YaST_BYTECODE_HEADER YaST_BYTECODE_MAJOR "." YaST_BYTECODE_MINOR "." YaST_BYTECODE_RELEASE);
     outstream.write (header.c_str(), header.size() + 1);	// including trailing \0
 
+    writepool_t pool;
+    outstream.pword (poolSlot ()) = &pool;
     code->toStream (outstream);
+    outstream.pword (poolSlot ()) = 0;
 
+    outstream.close ();
     return ! outstream.fail ();
 }
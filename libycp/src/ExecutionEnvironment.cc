@@ -12,7 +12,10 @@
  *
  */
 
+#include <unordered_set>
+
 #include "ycp/ExecutionEnvironment.h"
+#include "ycp/Profiler.h"
 
 #include "ycp/YStatement.h"
 
@@ -24,13 +27,25 @@ namespace YaST
 // the number of call frames to show warning at
 #define WARN_RECURSION 1001
 static const char * Y2RECURSIONLIMIT = "Y2RECURSIONLIMIT";
+static const char * Y2PROFILE = "Y2PROFILE";
+static const char * Y2CALLSTATS = "Y2CALLSTATS";
 
 
     ExecutionEnvironment ee;
 
 
+// file names for ExecutionEnvironment::m_filename and CallFrame::filename
+static const string*
+internFilename (const string& filename)
+{
+    // never freed, ee may be used during static destruction
+    static std::unordered_set<string>* filenames = new std::unordered_set<string>;
+    return &*filenames->insert (filename).first;
+}
+
+
 ExecutionEnvironment::ExecutionEnvironment ()
-    : m_filename ("")
+    : m_filename (internFilename (""))
     , m_forced_filename (false)
     , m_statement(NULL)
 {
@@ -42,6 +57,14 @@ ExecutionEnvironment::ExecutionEnvironment ()
 	m_recursion_limit = atoi (s);
     if (m_recursion_limit == 0)
 	m_recursion_limit = WARN_RECURSION;
+
+    s = getenv (Y2PROFILE);
+    if (s != NULL && *s != 0)
+	Profiler::start (s);
+
+    s = getenv (Y2CALLSTATS);
+    if (s != NULL && *s != 0)
+	CallStats::start (s);
 }
 
 int
@@ -58,22 +81,45 @@ ExecutionEnvironment::setLinenumber (int line)
 }
 
 
+ExecutionEnvironment::~ExecutionEnvironment ()
+{
+    for (vector<CallFrame*>::iterator it = m_frames.begin (); it != m_frames.end (); ++it)
+	delete *it;
+}
+
+
 const string&
 ExecutionEnvironment::filename() const
 {
-    return m_filename;
+    return *m_filename;
 }
 
 
 void
 ExecutionEnvironment::setFilename (const string & filename)
 {
-    m_filename = filename;
+    if (*m_filename != filename)
+	m_filename = internFilename (filename);
     m_forced_filename = true;
     return;
 }
 
 
+const string*
+ExecutionEnvironment::filenamePtr () const
+{
+    return m_filename;
+}
+
+
+void
+ExecutionEnvironment::setFilenamePtr (const string* filename)
+{
+    m_filename = filename;
+    m_forced_filename = true;
+}
+
+
 YStatementPtr
 ExecutionEnvironment::statement () const
 {
@@ -84,6 +130,9 @@ ExecutionEnvironment::statement () const
 void
 ExecutionEnvironment::setStatement (YStatementPtr s)
 {
+    // a pending tick belongs to the statement we are leaving
+    Profiler::checkpoint ();
+
     m_statement = s;
 
     if (s != NULL)
@@ -109,7 +158,16 @@ void
 ExecutionEnvironment::pushframe (YECallPtr function, YCPValue m_params[])
 {
     y2debug ("Push frame %s", function->entry()->name());
-    CallFrame* frame = new CallFrame (filename(), linenumber (), function, m_params);
+    Profiler::checkpoint ();
+    size_t depth = m_backtrace.size ();
+    if (depth == m_frames.size ())
+	m_frames.push_back (new CallFrame);
+
+    CallFrame* frame = m_frames[depth];
+    frame->function = function;
+    frame->filename = m_filename;
+    frame->linenumber = linenumber ();
+    frame->params = m_params;
     m_backtrace.push_back (frame);
     // backtrace( LOG_MILESTONE, 0 );
 }
@@ -119,10 +177,13 @@ void
 ExecutionEnvironment::popframe ()
 {
     y2debug ("Pop frame %p", m_backtrace.back ());
-    const CallFrame* frame = m_backtrace.back ();
+    Profiler::checkpoint ();
+    CallFrame* frame = m_frames[m_backtrace.size () - 1];
     m_backtrace.pop_back ();
     // backtrace( LOG_MILESTONE, 0 );
-    delete frame;
+    // the frame stays for the next push, but must not keep the call alive
+    frame->function = 0;
+    frame->params = 0;
 }
 
 
@@ -139,7 +200,7 @@ ExecutionEnvironment::backtrace (loglevel_t level, uint omit) const
 
     while (it != m_backtrace.rend())
     {
-	ycp2log (level, (*it)->filename.c_str (), (*it)->linenumber
+	ycp2log (level, (*it)->filename->c_str (), (*it)->linenumber
 		 , "", "%s", (*it)->function->entry()->toString().c_str());
 	++it;
     };
@@ -0,0 +1,346 @@
+/*---------------------------------------------------------------------\
+|								       |
+|		       __   __	  ____ _____ ____		       |
+|		       \ \ / /_ _/ ___|_   _|___ \		       |
+|			\ V / _` \___ \ | |   __) |		       |
+|			 | | (_| |___) || |  / __/		       |
+|			 |_|\__,_|____/ |_| |_____|		       |
+|								       |
+|				core system			       |
+|							 (C) SuSE GmbH |
+\----------------------------------------------------------------------/
+
+   File:	Profiler.cc
+
+   Sampling profiler and call statistics for YCP code
+
+/-*/
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include "ycp/Profiler.h"
+#include "ycp/ExecutionEnvironment.h"
+#include "ycp/StaticDeclaration.h"
+#include "ycp/y2log.h"
+#include "y2/SymbolEntry.h"
+#include "y2/Y2Namespace.h"
+
+namespace YaST
+{
+
+volatile sig_atomic_t Profiler::s_ticks = 0;
+
+// folded stack -> number of ticks
+static std::map<string, unsigned long>* samples = 0;
+static string* output_name = 0;	// may be started during static initialization
+static bool running = false;
+
+
+void
+Profiler::tick (int)
+{
+    s_ticks = s_ticks + 1;
+}
+
+
+bool
+Profiler::start (const string& output, int frequency)
+{
+    if (running)
+    {
+	y2error ("Profiler already running");
+	return false;
+    }
+    if (frequency <= 0 || frequency > 1000000)
+	frequency = DEFAULT_FREQUENCY;
+
+    struct sigaction sa;
+    memset (&sa, 0, sizeof (sa));
+    sa.sa_handler = tick;
+    sa.sa_flags = SA_RESTART;		// agents do not expect EINTR
+    sigemptyset (&sa.sa_mask);
+    if (sigaction (SIGPROF, &sa, NULL) != 0)
+    {
+	y2error ("Cannot install SIGPROF handler: %s", strerror (errno));
+	return false;
+    }
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000 / frequency;
+    timer.it_value = timer.it_interval;
+    if (setitimer (ITIMER_PROF, &timer, NULL) != 0)
+    {
+	y2error ("Cannot start profiling timer: %s", strerror (errno));
+	return false;
+    }
+
+    if (samples == 0)
+    {
+	samples = new std::map<string, unsigned long>;
+	atexit (atExit);
+    }
+    if (output_name == 0)
+	output_name = new string;
+    *output_name = output;
+    s_ticks = 0;
+    running = true;
+
+    y2milestone ("Profiling at %d Hz to %s", frequency, output.c_str ());
+    return true;
+}
+
+
+void
+Profiler::sample ()
+{
+    unsigned long ticks = s_ticks;
+    s_ticks = 0;
+    if (!running)
+	return;
+
+    string stack;
+    const ExecutionEnvironment::CallStack& frames = ee.callstack ();
+    for (ExecutionEnvironment::CallStack::const_iterator it = frames.begin (); it != frames.end (); ++it)
+    {
+	stack += (*it)->function->qualifiedName ();
+	stack += ';';
+    }
+
+    char line[16];
+    snprintf (line, sizeof (line), ":%d", ee.linenumber ());
+    stack += ee.filename ().empty () ? string ("<unknown>") : ee.filename ();
+    stack += line;
+
+    (*samples)[stack] += ticks;
+}
+
+
+void
+Profiler::stop ()
+{
+    if (!running)
+	return;
+
+    struct itimerval timer;
+    memset (&timer, 0, sizeof (timer));
+    setitimer (ITIMER_PROF, &timer, NULL);
+    signal (SIGPROF, SIG_IGN);
+    running = false;
+
+    FILE* out = fopen (output_name->c_str (), "w");
+    if (out == NULL)
+    {
+	y2error ("Cannot write profile to %s: %s", output_name->c_str (), strerror (errno));
+	return;
+    }
+
+    unsigned long total = 0;
+    for (std::map<string, unsigned long>::const_iterator it = samples->begin (); it != samples->end (); ++it)
+    {
+	fprintf (out, "%s %lu\n", it->first.c_str (), it->second);
+	total += it->second;
+    }
+    fclose (out);
+    samples->clear ();
+
+    y2milestone ("Wrote %lu samples to %s", total, output_name->c_str ());
+}
+
+
+void
+Profiler::atExit ()
+{
+    stop ();
+}
+
+
+// ------------------------------------------------------------------
+
+bool CallStats::s_enabled = false;
+volatile sig_atomic_t CallStats::s_dump = 0;
+CallTimer* CallStats::s_current = 0;
+
+// callee (SymbolEntry or declaration_t) -> counters
+typedef std::unordered_map<const void*, CallStats::entry_t> entries_t;
+static entries_t* entries = 0;
+static string* report_name = 0;
+
+
+static inline uint64_t
+now ()
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+void
+CallStats::request (int)
+{
+    s_dump = 1;
+}
+
+
+bool
+CallStats::start (const string& output)
+{
+    if (s_enabled)
+    {
+	y2error ("Call statistics already enabled");
+	return false;
+    }
+
+    struct sigaction sa;
+    memset (&sa, 0, sizeof (sa));
+    sa.sa_handler = request;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset (&sa.sa_mask);
+    if (sigaction (SIGRTMIN, &sa, NULL) != 0)
+    {
+	y2error ("Cannot install SIGRTMIN handler: %s", strerror (errno));
+    }
+
+    if (entries == 0)
+    {
+	entries = new entries_t;
+	report_name = new string;
+	atexit (atExit);
+    }
+    *report_name = output;
+    s_enabled = true;
+
+    y2milestone ("Counting calls to %s", output.c_str ());
+    return true;
+}
+
+
+static CallStats::entry_t*
+lookup (const void* key, bool& created)
+{
+    std::pair<entries_t::iterator, bool> res = entries->insert (std::make_pair (key, CallStats::entry_t ()));
+    created = res.second;
+    CallStats::entry_t& e = res.first->second;
+    if (created)
+    {
+	e.calls = 0;
+	e.inclusive = e.exclusive = 0;
+	e.active = 0;
+    }
+    return &e;
+}
+
+
+CallStats::entry_t*
+CallStats::function (const SymbolEntry* sentry)
+{
+    bool created;
+    entry_t* e = lookup (sentry, created);
+    if (created)
+    {
+	const Y2Namespace* ns = sentry->nameSpace ();
+	e->name = (ns && !ns->name ().empty ()) ? ns->name () + "::" + sentry->name () : string (sentry->name ());
+    }
+    return e;
+}
+
+
+CallStats::entry_t*
+CallStats::builtin (const declaration_t* decl)
+{
+    bool created;
+    entry_t* e = lookup (decl, created);
+    if (created)
+    {
+	// overloads share the name, add the type
+	e->name = StaticDeclaration::Decl2String (decl, false) + " : " + decl->type->toString ();
+    }
+    return e;
+}
+
+
+static bool
+by_exclusive (const CallStats::entry_t* a, const CallStats::entry_t* b)
+{
+    return a->exclusive > b->exclusive;
+}
+
+
+void
+CallStats::dump ()
+{
+    s_dump = 0;
+    if (entries == 0)
+	return;
+
+    FILE* out = fopen (report_name->c_str (), "w");
+    if (out == NULL)
+    {
+	y2error ("Cannot write call statistics to %s: %s", report_name->c_str (), strerror (errno));
+	return;
+    }
+
+    std::vector<const entry_t*> sorted;
+    sorted.reserve (entries->size ());
+    for (entries_t::const_iterator it = entries->begin (); it != entries->end (); ++it)
+	sorted.push_back (&it->second);
+    std::sort (sorted.begin (), sorted.end (), by_exclusive);
+
+    fprintf (out, "%12s %14s %14s  %s\n", "calls", "inclusive ms", "exclusive ms", "function");
+    for (std::vector<const entry_t*>::const_iterator it = sorted.begin (); it != sorted.end (); ++it)
+    {
+	fprintf (out, "%12lu %14.3f %14.3f  %s\n", (*it)->calls,
+		 (*it)->inclusive / 1e6, (*it)->exclusive / 1e6, (*it)->name.c_str ());
+    }
+    fclose (out);
+}
+
+
+void
+CallStats::atExit ()
+{
+    dump ();
+}
+
+
+void
+CallTimer::start (CallStats::entry_t* entry)
+{
+    m_entry = entry;
+    m_entry->active++;
+    m_parent = CallStats::s_current;
+    CallStats::s_current = this;
+    m_children = 0;
+    m_begin = now ();
+}
+
+
+void
+CallTimer::stop ()
+{
+    uint64_t elapsed = now () - m_begin;
+
+    m_entry->calls++;
+    m_entry->exclusive += elapsed - m_children;
+    if (--m_entry->active == 0)
+	m_entry->inclusive += elapsed;
+
+    if (m_parent)
+	m_parent->m_children += elapsed;
+    CallStats::s_current = m_parent;
+
+    if (CallStats::s_dump)
+	CallStats::dump ();
+}
+
+}
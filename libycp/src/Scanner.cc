@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <stdarg.h>
 #include <errno.h>
+#include <sys/stat.h>
 
 #include "ycp/Scanner.h"
 #include "ycp/y2log.h"
@@ -51,6 +52,10 @@ Scanner::Scanner (FILE *inputfile, const char *fname)
     , m_inputBuffer (0)
     , m_inputFile (inputfile)
     , m_inputFd (-1)
+    , m_readAheadPos (0)
+    , m_frameDepth (0)
+    , m_frameState (FRAME_CODE)
+    , m_frameLineStart (true)
     , m_scannedType (Type::Unspec)
     , m_lineNumber (1)
     , m_scandataBuffer (0)
@@ -72,6 +77,10 @@ Scanner::Scanner (const char *inputbuffer)
     , m_inputBuffer (inputbuffer)
     , m_inputFile (0)
     , m_inputFd (-1)
+    , m_readAheadPos (0)
+    , m_frameDepth (0)
+    , m_frameState (FRAME_CODE)
+    , m_frameLineStart (true)
     , m_scannedType (Type::Unspec)
     , m_lineNumber (1)
     , m_scandataBuffer (0)
@@ -93,6 +102,10 @@ Scanner::Scanner (int input_fd, const char *fname)
     , m_inputBuffer (0)
     , m_inputFile (0)
     , m_inputFd (input_fd)
+    , m_readAheadPos (0)
+    , m_frameDepth (0)
+    , m_frameState (FRAME_CODE)
+    , m_frameLineStart (true)
     , m_scannedType (Type::Unspec)
     , m_lineNumber (1)
     , m_scandataBuffer (0)
@@ -106,11 +119,37 @@ Scanner::Scanner (int input_fd, const char *fname)
     m_scannedValue.sval = 0;
     builtinTable = static_declarations.symbolTable();
     y2debug( "Scanner setting builtinTable to %p", builtinTable );
+
+    // continue with what a previous scanner read ahead from this file
+    std::map<int, read_ahead_t>::iterator it = s_pendingInput.find (input_fd);
+    if (it != s_pendingInput.end ())
+    {
+	struct stat st;
+	if (fstat (input_fd, &st) == 0
+	    && st.st_dev == it->second.dev && st.st_ino == it->second.ino)
+	{
+	    m_readAhead.swap (it->second.data);
+	}
+	s_pendingInput.erase (it);
+    }
 }
 
 
 Scanner::~Scanner ()
 {
+    // keep unused input for the next scanner on this file
+    if (m_inputFd >= 0 && m_readAheadPos < m_readAhead.size ())
+    {
+	struct stat st;
+	if (fstat (m_inputFd, &st) == 0)
+	{
+	    read_ahead_t& pending = s_pendingInput[m_inputFd];
+	    pending.dev = st.st_dev;
+	    pending.ino = st.st_ino;
+	    pending.data = m_readAhead.substr (m_readAheadPos);
+	}
+    }
+
     if (m_scandataBuffer != 0)
 	free (m_scandataBuffer);
 
@@ -210,16 +249,22 @@ Scanner::LexerInput (char* buf, int maxnum)
 
     else if (m_inputFile)
     {
-	return fread (buf, 1, m_buffered ? maxnum : 1, m_inputFile);
+	if (!m_buffered)
+	    return readFramedFile (buf, maxnum);
+
+	return fread (buf, 1, maxnum, m_inputFile);
     }
 
     // reading from a file descriptor
 
     else if (m_inputFd >= 0)
     {
+	if (!m_buffered || m_readAheadPos < m_readAhead.size ())
+	    return readFramedFd (buf, maxnum);
+
 	ssize_t read_bytes;
 	do {
-	    read_bytes = read (m_inputFd, buf, m_buffered ? maxnum : 1);
+	    read_bytes = read (m_inputFd, buf, maxnum);
 	} while (read_bytes == -1 &&
 			(errno == EINTR || errno == ERESTART)); // bnc#434253
 
@@ -239,6 +284,162 @@ Scanner::LexerInput (char* buf, int maxnum)
 }
 
 
+std::map<int, Scanner::read_ahead_t> Scanner::s_pendingInput;
+
+
+bool
+Scanner::frameStep (char c)
+{
+    // a # comment must start the line, like ^[\t ]*# in scanner.ll
+    bool line_start = m_frameLineStart;
+    m_frameLineStart = (c == '\n') || (line_start && (c == ' ' || c == '\t'));
+
+    switch (m_frameState)
+    {
+	case FRAME_CODE:
+	    break;
+
+	case FRAME_STRING:
+	    if (c == '\\')
+		m_frameState = FRAME_STRING_ESCAPE;
+	    else if (c == '"')
+	    {
+		m_frameState = FRAME_CODE;
+		return m_frameDepth == 0;
+	    }
+	    return false;
+
+	case FRAME_STRING_ESCAPE:
+	    m_frameState = FRAME_STRING;
+	    return false;
+
+	case FRAME_SLASH:
+	    m_frameState = FRAME_CODE;
+	    if (c == '/')
+	    {
+		m_frameState = FRAME_LINE_COMMENT;
+		return false;
+	    }
+	    if (c == '*')
+	    {
+		m_frameState = FRAME_COMMENT;
+		return false;
+	    }
+	    break;
+
+	case FRAME_LINE_COMMENT:
+	    if (c != '\n')
+		return false;
+	    m_frameState = FRAME_CODE;
+	    return m_frameDepth == 0;
+
+	case FRAME_COMMENT:
+	    if (c == '*')
+		m_frameState = FRAME_COMMENT_STAR;
+	    return false;
+
+	case FRAME_COMMENT_STAR:
+	    if (c == '/')
+		m_frameState = FRAME_CODE;
+	    else if (c != '*')
+		m_frameState = FRAME_COMMENT;
+	    return false;
+    }
+
+    switch (c)
+    {
+	case '"':
+	    m_frameState = FRAME_STRING;
+	    return false;
+
+	case '[': case '(': case '{':
+	    m_frameDepth++;
+	    return false;
+
+	case ']': case ')': case '}':
+	    if (m_frameDepth > 0)
+		m_frameDepth--;
+	    return m_frameDepth == 0;
+
+	case '#':
+	    if (line_start)
+	    {
+		m_frameState = FRAME_LINE_COMMENT;
+		return false;
+	    }
+	    return m_frameDepth == 0;
+
+	case '/':
+	    // may start a comment, which may contain anything
+	    m_frameState = FRAME_SLASH;
+	    return m_frameDepth == 0;
+
+	default:
+	    // outside of brackets any token may be the end of the value
+	    return m_frameDepth == 0;
+    }
+}
+
+
+int
+Scanner::readFramedFd (char *buf, int maxnum)
+{
+    if (m_readAheadPos >= m_readAhead.size ())
+    {
+	char chunk[READ_AHEAD];
+	ssize_t read_bytes;
+	do {
+	    read_bytes = read (m_inputFd, chunk, sizeof (chunk));
+	} while (read_bytes == -1 &&
+			(errno == EINTR || errno == ERESTART)); // bnc#434253
+
+	if (read_bytes <= 0)
+	    return 0;
+
+	m_readAhead.assign (chunk, read_bytes);
+	m_readAheadPos = 0;
+    }
+
+    const char *data = m_readAhead.data () + m_readAheadPos;
+    int avail = m_readAhead.size () - m_readAheadPos;
+    if (avail > maxnum)
+	avail = maxnum;
+
+    // in buffered mode all of it may be passed on
+    int len = avail;
+    if (!m_buffered)
+    {
+	len = 0;
+	while (len < avail && !frameStep (data[len++]))
+	    ;
+    }
+
+    memcpy (buf, data, len);
+    m_readAheadPos += len;
+    return len;
+}
+
+
+int
+Scanner::readFramedFile (char *buf, int maxnum)
+{
+    // stdio buffers the file for us, but ungetc could only
+    // push back a single character, so stop at the frame end
+    int len = 0;
+    while (len < maxnum)
+    {
+	int c = getc (m_inputFile);
+	if (c == EOF)
+	    break;
+
+	buf[len++] = c;
+	if (frameStep (c))
+	    break;
+    }
+    return len;
+}
+
+
 void
 Scanner::LexerError (const char* msg)
 {
@@ -389,5 +590,9 @@ Scanner::closeInput ()
     else if (m_inputFd >= 0)
     {
 	close (m_inputFd);
+
+	// nothing left to read ahead from
+	m_readAhead.clear ();
+	m_readAheadPos = 0;
     }
 }
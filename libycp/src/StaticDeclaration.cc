@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <string>
 #include <map>
+#include <unordered_map>
 using namespace std;
 
 #include "ycp/StaticDeclaration.h"
@@ -78,6 +79,33 @@ StaticDeclaration::~StaticDeclaration ()
 }
 
 
+//------------------------------------------------------------------------
+// Builtins share many signatures ("boolean (string)", "integer (list <any>)"
+// ...), across modules and overloads. Parse each of them only once; types
+// are immutable, so the declarations can share them.
+
+static constTypePtr
+signatureType (const char *signature)
+{
+    typedef unordered_map<string, constTypePtr> signature_map_t;
+
+    // never destroyed, registration happens during static initialization
+    // and the types must outlive all declarations
+    static signature_map_t *parsed = new signature_map_t;
+
+    signature_map_t::const_iterator it = parsed->find (signature);
+    if (it != parsed->end ())
+    {
+	return it->second;
+    }
+
+    const char *s = signature;
+    constTypePtr type = Type::fromSignature (&s);
+    (*parsed)[signature] = type;
+    return type;
+}
+
+
 //------------------------------------------------------------------------
 // registration
 //
@@ -187,20 +215,20 @@ StaticDeclaration::registerDeclarations (const char *filename,
 	else	// normal entry, not namespace
 	{
 	    declarations->name_space = namespace_decl;
-	    string signature = declarations->signature;
+	    const char *signature = declarations->signature;
 
-	    constTypePtr type = Type::fromSignature (signature);
+	    constTypePtr type = signatureType (signature);
 	    if (type == 0
 		|| type->isError()
 		|| type->isUnspec()
 		|| type->isWildcard())
 	    {
-		y2error ("Invalid signature %s::%s:'%s'\n", filename, name, signature.c_str());
+		y2error ("Invalid signature %s::%s:'%s'\n", filename, name, signature);
 		return;
 	    }
 
 #if DO_DEBUG
-y2debug("%s sig[%s] type[%s]", name, signature.c_str(), type->toString().c_str());
+y2debug("%s sig[%s] type[%s]", name, signature, type->toString().c_str());
 #endif
 #if 0
 	    if (type->hasFlex()
@@ -510,7 +538,7 @@ StaticDeclaration::writeDeclaration (std::ostream & str, const declaration_t *de
 #endif
 
     Bytecode::writeCharp (str, n.c_str());
-    decl->type->toStream (str);
+    Bytecode::writeType (str, decl->type);
     return str;
 }
 
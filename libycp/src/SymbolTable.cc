@@ -46,6 +46,7 @@ TableEntry::TableEntry (const char *key, SymbolEntryPtr entry, const Point *poin
     , m_overloaded_next (0)
     , m_outer (0)
     , m_key (key)
+    , m_hash (0)
     , m_entry (entry)
     , m_point (point)
     , m_table (table)
@@ -60,6 +61,7 @@ TableEntry::TableEntry (bytecodeistream & str)
     , m_overloaded_next (0)
     , m_outer (0)
     , m_key (0)
+    , m_hash (0)
     , m_entry (0)
     , m_point (0)
     , m_table (0)
@@ -216,42 +218,120 @@ TableEntry::remove ()
 
 // SymbolTable
 
-int
+unsigned int
 SymbolTable::hash (const char *s)
 {
-//    y2debug( "hash called for %p", this );
-    const char *p;
-    unsigned int h = 0, g;
+    // FNV-1a
+    unsigned int h = 2166136261u;
 
-    for (p = s; *p != 0; p++)
+    for (const unsigned char *p = (const unsigned char *) s; *p != 0; p++)
     {
-	h = (h << 4) + *p;
-	if ((g = (h & 0xff000000)) != 0)
-	{
-	    h = h ^ (g >> 24);
-	    h = h ^ g;
-	}
+	h ^= *p;
+	h *= 16777619u;
     }
-    return h % m_prime;
+    return h;
 }
 
 
-SymbolTable::SymbolTable (int prime)
-    // The 31 used to be 211, but that is too much.
-    // because eg. in runlevel there's 1200 blocks
-    // and each has its symbol table.
-    // Better yet use rehashing - TODO
-    : m_prime ((prime <= 0) ? 31 : prime)
+SymbolTable::SymbolTable (int hashsize)
+    // Start small, eg. in runlevel there's 1200 blocks and each
+    // has its symbol table. Big tables grow as needed.
+    : m_size (8)
+    , m_count (0)
+    , m_oldTable (0)
+    , m_oldSize (0)
+    , m_migrated (0)
     , m_track_usage (true)
     , m_used (0)
     , m_xrefs (0)
 {
-    m_table = (TableEntry **)calloc (m_prime, sizeof (TableEntry *));
+    while (m_size < hashsize)
+    {
+	m_size <<= 1;
+    }
+    m_table = (TableEntry **)calloc (m_size, sizeof (TableEntry *));
 
 //    y2debug ("New table @ %p", this);
 }
 
 
+void
+SymbolTable::grow ()
+{
+#if DO_DEBUG
+    y2debug ("SymbolTable[%p]::grow %d entries, %d -> %d buckets", this, m_count, m_size, 2 * m_size);
+#endif
+    m_oldTable = m_table;
+    m_oldSize = m_size;
+    m_migrated = 0;
+
+    m_size *= 2;
+    m_table = (TableEntry **)calloc (m_size, sizeof (TableEntry *));
+}
+
+
+void
+SymbolTable::migrateBucket (int i)
+{
+    TableEntry *current = m_oldTable[i];
+    m_oldTable[i] = 0;
+
+    // the chain holds distinct keys, their scope and overload
+    // chains hang off them and move along
+    while (current)
+    {
+	TableEntry *next = current->m_next;
+
+	TableEntry **bucket = &m_table[current->m_hash & (m_size - 1)];
+	current->m_prev = 0;
+	current->m_next = *bucket;
+	if (*bucket)
+	    (*bucket)->m_prev = current;
+	*bucket = current;
+
+	current = next;
+    }
+}
+
+
+void
+SymbolTable::migrate (unsigned int h)
+{
+    if (m_oldTable == 0)
+    {
+	return;
+    }
+
+    migrateBucket (h & (m_oldSize - 1));
+
+    // and move on, so that the old table is gone after about
+    // m_oldSize / 2 operations
+    for (int steps = 0; steps < 2 && m_migrated < m_oldSize; steps++)
+    {
+	migrateBucket (m_migrated++);
+    }
+
+    if (m_migrated == m_oldSize)
+    {
+	free (m_oldTable);
+	m_oldTable = 0;
+	m_oldSize = 0;
+    }
+}
+
+
+void
+SymbolTable::finishMigration () const
+{
+    // walking all buckets does not change the contents
+    SymbolTable *self = const_cast<SymbolTable *> (this);
+    while (self->m_oldTable != 0)
+    {
+	self->migrate (0);
+    }
+}
+
+
 SymbolTable::~SymbolTable()
 {
 //    y2debug ("SymbolTable::~SymbolTable %p", this);
@@ -269,6 +349,8 @@ SymbolTable::~SymbolTable()
 
     endUsage ();
 
+    finishMigration ();
+
     int i;
     int count = 0;
     int used = 0;
@@ -278,7 +360,7 @@ SymbolTable::~SymbolTable()
 
     // for each entry in hashtable
 
-    for (i = 0; i < m_prime; i++)
+    for (i = 0; i < m_size; i++)
     {
 	current = m_table[i];
 	if (current != 0)
@@ -320,9 +402,9 @@ SymbolTable::~SymbolTable()
 	}
     }
 #if DO_DEBUG
-    y2debug ("%d of %d buckets used\n", used, m_prime);
-    y2debug ("%d elements, %d bucketuse\n", count, count / m_prime);
-    y2debug ("bucket size max %d, average %d\n", maxlen, (maxlen / m_prime) + 1);
+    y2debug ("%d of %d buckets used\n", used, m_size);
+    y2debug ("%d elements, %d bucketuse\n", count, count / m_size);
+    y2debug ("bucket size max %d, average %d\n", maxlen, (maxlen / m_size) + 1);
 #endif
     free (m_table);
 }
@@ -491,7 +573,7 @@ SymbolTable::writeUsage (std::ostream & str) const
 	else y2debug("XRef %p::%s @ %d\n", this, sentry->toString().c_str(), position);
 #endif
 	Bytecode::writeCharp (str, sentry->name());
-	sentry->type()->toStream (str);
+	Bytecode::writeType (str, sentry->type());
 	sentry->setPosition (-position - 1);			// negative position -> Xref
 	position++;
     }
@@ -558,7 +640,7 @@ SymbolTable::writeXmlUsage (std::ostream & str, int indent ) const
 int
 SymbolTable::size() const
 {
-    return m_prime;
+    return m_size;
 }
 
 
@@ -584,7 +666,11 @@ SymbolTable::enter (TableEntry *entry)
 	y2debug ("SymbolTable %p before (%s)\n", this, toString().c_str());
     }
 #endif
-    int h = hash (key);			// compute hash
+    unsigned int hv = hash (key);	// compute hash
+    entry->m_hash = hv;
+    migrate (hv);
+
+    int h = hv & (m_size - 1);
     bucket = m_table[h];
 
     if (bucket == 0)			// first entry in bucket
@@ -593,12 +679,15 @@ SymbolTable::enter (TableEntry *entry)
 	if (SymbolTableDebug) y2debug ("first entry in bucket");
 #endif
 	m_table[h] = entry;
+	m_count++;
     }
     else
     {
 	while (bucket)				// find match in bucket list
 	{
-	    if (strcmp (key, bucket->m_key) == 0)	// match !
+	    if (bucket->m_hash == hv
+		&& (key == bucket->m_key
+		    || strcmp (key, bucket->m_key) == 0))	// match !
 	    {
 #if DO_DEBUG
 		if (SymbolTableDebug) y2debug ("match, add as new scope");
@@ -666,6 +755,7 @@ SymbolTable::enter (TableEntry *entry)
 #endif
 		bucket->m_next = entry;
 		entry->m_prev = bucket;
+		m_count++;
 
 		break;		// done
 	    }
@@ -675,6 +765,13 @@ SymbolTable::enter (TableEntry *entry)
 	}  // while bucket
 
     }
+
+    if (m_oldTable == 0
+	&& m_count * 4 > m_size * 3)
+    {
+	grow ();
+    }
+
 #if DO_DEBUG
     if (SymbolTableDebug) y2debug ("Table after (%s)\n", toString().c_str());
 #endif
@@ -691,12 +788,15 @@ SymbolTable::find (const char *key, SymbolEntry::category_t category)
 
     // Not ready during initial __ctor__    y2debug ("SymbolTable::find (%s)\n", key);
 
-    int h = hash (key);			// compute hash
-    tentry = m_table[h];
+    unsigned int hv = hash (key);	// compute hash
+    migrate (hv);
+    tentry = m_table[hv & (m_size - 1)];
 
     while (tentry != 0)			// search in hash chain
     {
-	if (strcmp (key, tentry->m_key) == 0)
+	if (tentry->m_hash == hv
+	    && (key == tentry->m_key
+		|| strcmp (key, tentry->m_key) == 0))
 	{
 	    if ((category == SymbolEntry::c_unspec)		// wildcard
 		|| (tentry->sentry()->category() == category))	// or matching
@@ -753,6 +853,9 @@ SymbolTable::remove (TableEntry *entry)
 //    y2debug ("SymbolTable(%p)::remove (%p)[%s]\n", this, entry, entry->m_key);
 //    y2debug ("before remove (%s)", toString().c_str());
 
+    migrate (entry->m_hash);
+    int h = entry->m_hash & (m_size - 1);
+
     // unlink from bucket stack
     // pop up bucket stack
 
@@ -760,7 +863,18 @@ SymbolTable::remove (TableEntry *entry)
 
     TableEntry *candidate = entry->m_outer;
 
-    if (candidate != 0)						// have an outer entry with equal key
+    if (entry->m_overloaded_prev != 0)			// not the first overloaded entry
+    {
+	entry->m_overloaded_prev->m_overloaded_next = entry->m_overloaded_next;
+	if (entry->m_overloaded_next != 0)
+	    entry->m_overloaded_next->m_overloaded_prev = entry->m_overloaded_prev;
+    }
+    else if (m_table[h] != entry && entry->m_prev == 0)
+    {
+	// not in the hash chain but somewhere down a scope chain
+	unlinkOuter (entry, h);
+    }
+    else if (candidate != 0)					// have an outer entry with equal key
     {
 	//y2debug ("SymbolTable: Pop scope\n");
 
@@ -776,74 +890,49 @@ SymbolTable::remove (TableEntry *entry)
 	}
 	else
 	{
-	    int h = hash (entry->m_key);
-
-	    if (m_table[h] == entry)
-	    {
-		m_table[h] = candidate;		// next is new first
-	    }
-	    else
-	    {
-		// fix the m_outer chain
-		TableEntry *shadow = m_table[h];
-		while (shadow)
-		{
-		    if (shadow->m_outer == entry)
-		    {
-			shadow->m_outer = entry->m_outer;
-			break;
-		    }
-		}
-
-		if (!shadow)
-		{
-		    y2internal ("Could not fix the symbol table for %s", entry->key ());
-		}
-	    }
+	    m_table[h] = candidate;		// next is new first
 	}
-
     }
     else if (entry->m_prev != 0)		// not first in bucket list
     {
 	entry->m_prev->m_next = entry->m_next;
 	if (entry->m_next)
 	    entry->m_next->m_prev = entry->m_prev;
+	m_count--;
     }
     else					// first in bucket list
     {
 	//y2debug ("SymbolTable: First in bucket\n");
-	int h = hash (entry->m_key);
+	m_table[h] = entry->m_next;	// next is new first
+	if (entry->m_next != 0)
+	    entry->m_next->m_prev = 0;
+	m_count--;
+    }
 
-	if (m_table[h] == entry)
-	{
-	    m_table[h] = entry->m_next;	// next is new first
-	    if (entry->m_next != 0)
-		entry->m_next->m_prev = 0;
-	}
-	else
-	{
-	    // removing m_outer
-	    TableEntry *shadow = m_table[h];
-	    while (shadow)
-	    {
-		if (shadow->m_outer == entry)
-		{
-		    shadow->m_outer = entry->m_outer;
-		    break;
-		}
-	    }
+    delete entry;
 
-	    if (!shadow)
+//    y2debug ("after remove (%s)", toString().c_str());
+    return;
+}
+
+
+void
+SymbolTable::unlinkOuter (TableEntry *entry, int h)
+{
+    // find the entry this one is the m_outer of
+    for (TableEntry *head = m_table[h]; head; head = head->m_next)
+    {
+	for (TableEntry *shadow = head; shadow; shadow = shadow->m_outer)
+	{
+	    if (shadow->m_outer == entry)
 	    {
-		y2internal ("Could not fix the symbol table for %s", entry->key ());
+		shadow->m_outer = entry->m_outer;
+		return;
 	    }
 	}
     }
 
-    delete entry;
-
-//    y2debug ("after remove (%s)", toString().c_str());
-    return;
+    y2internal ("Could not fix the symbol table for %s", entry->key ());
 }
 
 
@@ -857,7 +946,9 @@ SymbolTable::toString() const
     int i;
     // for each entry in hashtable
 
-    for (i = 0; i < m_prime; i++)
+    finishMigration ();
+
+    for (i = 0; i < m_size; i++)
     {
 	TableEntry *current = m_table[i];
 	if (current != 0)
@@ -928,7 +1019,9 @@ SymbolTable::toStringSymbols() const
     int i;
     // for each entry in hashtable
 
-    for (i = 0; i < m_prime; i++)
+    finishMigration ();
+
+    for (i = 0; i < m_size; i++)
     {
 	TableEntry *current = m_table[i];
 	if (current != 0)
@@ -995,7 +1088,9 @@ SymbolTable::toStringSymbols() const
 void
 SymbolTable::tableCopy(Y2Namespace* tofill) const
 {
-    for (int i=0; i < m_prime; i++)
+    finishMigration ();
+
+    for (int i=0; i < m_size; i++)
     {
 	if (m_table[i] != 0)
 	{
@@ -1024,7 +1119,9 @@ SymbolTable::tableCopy(Y2Namespace* tofill) const
 void
 SymbolTable::forEach(SymbolTable::EntryConsumer consumer) const
 {
-    for (int i=0; i < m_prime; i++)
+    finishMigration ();
+
+    for (int i=0; i < m_size; i++)
     {
 	if (m_table[i] != 0)
 	{
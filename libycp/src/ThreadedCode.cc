@@ -0,0 +1,326 @@
+/*---------------------------------------------------------------------\
+|								       |
+|		       __   __	  ____ _____ ____		       |
+|		       \ \ / /_ _/ ___|_   _|___ \		       |
+|			\ V / _` \___ \ | |   __) |		       |
+|			 | | (_| |___) || |  / __/		       |
+|			 |_|\__,_|____/ |_| |_____|		       |
+|								       |
+|				core system			       |
+|							 (C) SuSE GmbH |
+\----------------------------------------------------------------------/
+
+   File:	ThreadedCode.cc
+
+   Linear, direct threaded form of YCode expression trees
+
+/-*/
+
+#include <stdlib.h>
+
+#include "ycp/ThreadedCode.h"
+#include "ycp/YExpression.h"
+#include "ycp/YCPVoid.h"
+#include "ycp/y2log.h"
+
+#ifndef DO_DEBUG
+#define DO_DEBUG 0
+#endif
+
+typedef YCPValue (*v2v) (const YCPValue &);
+typedef YCPValue (*v2vv) (const YCPValue &, const YCPValue &);
+
+
+int ThreadedCode::s_enabled = -1;
+
+
+bool
+ThreadedCode::enabled ()
+{
+    if (s_enabled < 0)
+    {
+	s_enabled = (getenv ("Y2THREADED") != 0);
+    }
+    return s_enabled;
+}
+
+
+void
+ThreadedCode::setEnabled (bool enable)
+{
+    s_enabled = enable;
+}
+
+
+ThreadedCode::instruction_t::instruction_t (opcode_t o)
+    : handler (0)
+    , op (o)
+    , value (YCPNull ())
+    , entry (0)
+    , code (0)
+    , decl (0)
+    , arg (0)
+{
+}
+
+
+ThreadedCode::ThreadedCode ()
+    : m_linked (false)
+{
+}
+
+
+// can the node be turned into instructions (as opposed to OP_EVALUATE)?
+
+bool
+ThreadedCode::lowerable (YCode *code)
+{
+    switch (code->kind ())
+    {
+	case YCode::yeUnary:
+	{
+	    YEUnary *unary = static_cast<YEUnary *> (code);
+	    return unary->m_decl != 0 && unary->m_arg != 0;
+	}
+	case YCode::yeBinary:
+	{
+	    YEBinary *binary = static_cast<YEBinary *> (code);
+	    return binary->m_decl != 0
+		&& (binary->m_decl->flags & DECL_NOEVAL) != DECL_NOEVAL
+		&& binary->m_arg1 != 0 && binary->m_arg2 != 0;
+	}
+	case YCode::yeCompare:
+	{
+	    YECompare *compare = static_cast<YECompare *> (code);
+	    return compare->m_left != 0 && compare->m_right != 0;
+	}
+	default:
+	    break;
+    }
+    return false;
+}
+
+
+ThreadedCode *
+ThreadedCode::compile (YCode *code)
+{
+    if (code == 0 || !lowerable (code))
+    {
+	return 0;
+    }
+
+    ThreadedCode *threaded = new ThreadedCode;
+    threaded->emitTree (code, 0);
+    threaded->m_code.push_back (instruction_t (OP_END));
+
+#if DO_DEBUG
+    y2debug ("ThreadedCode: %s -> %zu instructions", code->toString ().c_str (), threaded->m_code.size ());
+#endif
+    return threaded;
+}
+
+
+// emit code pushing the value of code, depth values are on the stack already
+
+void
+ThreadedCode::emit (YCodePtr code, int depth)
+{
+    if (code->isConstant ())
+    {
+	instruction_t i (OP_CONST);
+	i.value = code->evaluate ();
+	m_code.push_back (i);
+    }
+    else if (code->kind () == YCode::yeVariable)
+    {
+	instruction_t i (OP_VARIABLE);
+	i.entry = ((YEVariablePtr) code)->entry ();
+	i.code = code;
+	m_code.push_back (i);
+    }
+    else if (depth + 2 <= MAX_DEPTH
+	     && lowerable (code.operator-> ()))
+    {
+	emitTree (code.operator-> (), depth);
+    }
+    else
+    {
+	instruction_t i (OP_EVALUATE);
+	i.code = code;
+	m_code.push_back (i);
+    }
+}
+
+
+// emit the instructions for a lowerable node
+
+void
+ThreadedCode::emitTree (YCode *code, int depth)
+{
+    switch (code->kind ())
+    {
+	case YCode::yeUnary:
+	{
+	    YEUnary *unary = static_cast<YEUnary *> (code);
+	    emit (unary->m_arg, depth);
+
+	    instruction_t i (OP_UNARY);
+	    i.decl = unary->m_decl;
+	    i.code = unary->m_arg;
+	    m_code.push_back (i);
+	}
+	break;
+
+	case YCode::yeBinary:
+	{
+	    YEBinary *binary = static_cast<YEBinary *> (code);
+	    emit (binary->m_arg1, depth);
+
+	    // YEBinary does not evaluate the second argument if the first is nil
+	    int check = m_code.size ();
+	    instruction_t c (OP_CHECK);
+	    c.decl = binary->m_decl;
+	    c.code = binary->m_arg1;
+	    m_code.push_back (c);
+
+	    emit (binary->m_arg2, depth + 1);
+
+	    instruction_t i (OP_BINARY);
+	    i.decl = binary->m_decl;
+	    i.code = binary->m_arg2;
+	    m_code.push_back (i);
+
+	    m_code[check].arg = m_code.size ();
+	}
+	break;
+
+	case YCode::yeCompare:
+	{
+	    YECompare *compare = static_cast<YECompare *> (code);
+	    emit (compare->m_left, depth);
+	    emit (compare->m_right, depth + 1);
+
+	    instruction_t i (OP_COMPARE);
+	    i.arg = compare->m_op;
+	    m_code.push_back (i);
+	}
+	break;
+
+	default:
+	    y2internal ("ThreadedCode: cannot lower %s", code->toString ().c_str ());
+	break;
+    }
+}
+
+
+YCPValue
+ThreadedCode::evaluate ()
+{
+    static const void *handlers[] = {
+	&&op_const, &&op_variable, &&op_evaluate, &&op_unary,
+	&&op_check, &&op_binary, &&op_compare, &&op_end
+    };
+
+    if (!m_linked)
+    {
+	for (std::vector<instruction_t>::iterator it = m_code.begin (); it != m_code.end (); ++it)
+	{
+	    it->handler = handlers[it->op];
+	}
+	m_linked = true;
+    }
+
+    // must be local, the code may be entered recursively
+    YCPValue stack[MAX_DEPTH] = { YCPNull(), YCPNull(), YCPNull(), YCPNull(), YCPNull(), YCPNull(), YCPNull(), YCPNull() };
+    YCPValue *sp = stack;			// next free slot
+    const instruction_t *pc = &m_code[0];
+
+#define DISPATCH goto *pc->handler
+
+    DISPATCH;
+
+op_const:
+    *sp++ = pc->value;
+    pc++;
+    DISPATCH;
+
+op_variable:
+    {
+	YCPValue value = pc->entry->value ();
+	// let YEVariable report (or handle) a missing value
+	*sp++ = value.isNull () ? pc->code->evaluate () : value;
+    }
+    pc++;
+    DISPATCH;
+
+op_evaluate:
+    *sp++ = pc->code->evaluate ();
+    pc++;
+    DISPATCH;
+
+op_unary:
+    {
+	// same as YEUnary::evaluate
+	YCPValue &arg = sp[-1];
+	if (arg.isNull ()
+	    && (pc->decl->flags & DECL_NIL) == 0)
+	{
+	    ycp2error ("Argument (%s) to %s(...) is nil", pc->code->toString().c_str(), pc->decl->name);
+	    arg = YCPNull ();
+	}
+	else
+	{
+	    arg = (*(v2v)pc->decl->ptr) (arg);
+	}
+    }
+    pc++;
+    DISPATCH;
+
+op_check:
+    {
+	// same as the first argument check in YEBinary::evaluate
+	YCPValue &arg1 = sp[-1];
+	if ((arg1.isNull () || arg1->isVoid ())
+	    && (pc->decl->flags & DECL_NIL) == 0)
+	{
+	    ycp2error ("Argument (%s) to %s(...) evaluates to nil", pc->code->toString().c_str(), pc->decl->name);
+	    arg1 = YCPNull ();
+	    pc = &m_code[pc->arg];
+	    DISPATCH;
+	}
+    }
+    pc++;
+    DISPATCH;
+
+op_binary:
+    {
+	// same as YEBinary::evaluate
+	sp--;
+	YCPValue &arg1 = sp[-1];
+	YCPValue &arg2 = sp[0];
+	if ((arg2.isNull () || arg2->isVoid ())
+	    && (pc->decl->flags & DECL_NIL) == 0)
+	{
+	    ycp2error ("Argument (%s) to %s(...) evaluates to nil", pc->code->toString().c_str(), pc->decl->name);
+	    arg1 = YCPNull ();
+	}
+	else
+	{
+	    arg1 = (*(v2vv)pc->decl->ptr) (arg1, arg2);
+	}
+	arg2 = YCPNull ();
+    }
+    pc++;
+    DISPATCH;
+
+op_compare:
+    sp--;
+    sp[-1] = YECompare::compare (sp[-1], (YECompare::c_op) pc->arg, sp[0]);
+    sp[0] = YCPNull ();
+    pc++;
+    DISPATCH;
+
+op_end:
+#undef DISPATCH
+    return stack[0];
+}
@@ -591,10 +591,10 @@ YBlock::evaluate (bool cse)
     bool old_m_running = m_running;
     m_running = true;
 
-    string restore_name;
+    const string* restore_name = 0;
     if (!filename().empty())
     {
-	restore_name = YaST::ee.filename();
+	restore_name = YaST::ee.filenamePtr();
 	YaST::ee.setFilename(filename());
     }
 
@@ -621,9 +621,9 @@ YBlock::evaluate (bool cse)
 
 	stmt = stmt->next;
     }
-    if (!restore_name.empty())
+    if (restore_name && !restore_name->empty())
     {
-	YaST::ee.setFilename(restore_name);
+	YaST::ee.setFilenamePtr(restore_name);
     }
 
     m_running = old_m_running;
@@ -670,10 +670,10 @@ YBlock::evaluateFrom (int statement_index)
     bool old_m_running = m_running;
     m_running = true;
 
-    string restore_name;
+    const string* restore_name = 0;
     if (!filename().empty())
     {
-	restore_name = YaST::ee.filename();
+	restore_name = YaST::ee.filenamePtr();
 	YaST::ee.setFilename(filename());
     }
 
@@ -709,9 +709,9 @@ YBlock::evaluateFrom (int statement_index)
 
 	stmt = stmt->next;
     }
-    if (!restore_name.empty())
+    if (restore_name && !restore_name->empty())
     {
-	YaST::ee.setFilename(restore_name);
+	YaST::ee.setFilenamePtr(restore_name);
     }
 
     m_running = old_m_running;
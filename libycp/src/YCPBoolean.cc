@@ -81,6 +81,13 @@ YCPBooleanRep::compare(const YCPBoolean& b) const
 }
 
 
+size_t
+YCPBooleanRep::hash() const
+{
+    return v ? 1 : 0;
+}
+
+
 // --------------------------------------------------------
 
 YCPBoolean* YCPBoolean::trueboolean = NULL;
@@ -19,11 +19,9 @@
 
 /-*/
 
-#include <set>			// for toset
+#include <unordered_set>		// for union, toset
 #include <algorithm>		// sort
 
-using std::set;
-
 #include "ycp/YCPBuiltinList.h"
 #include "ycp/YCPList.h"
 #include "ycp/YCPMap.h"
@@ -187,8 +185,6 @@ l_unionlist (const YCPList &list1, const YCPList &list2)
      * preserved. Elements of <tt>l1</tt> are prior to elements from <tt>l2</tt>.
      * <tt>nil</tt> as either argument makes the result <tt>nil</tt> too.
      *
-     * WARNING: quadratic complexity so far
-     *
      * @see merge
      * @usage union ([1, 2], [3, 4]) -> [1, 2, 3, 4]
      * @usage union ([1, 2, 3], [2, 3, 4]) -> [1, 2, 3, 4]
@@ -202,6 +198,10 @@ l_unionlist (const YCPList &list1, const YCPList &list2)
 
     YCPList newlist;
 
+    // elements already in newlist
+    std::unordered_set<YCPValue, ycp_hash, ycp_equal_to> contained;
+    contained.reserve (list1->size () + list2->size ());
+
     for (int l = 0; l < 2; l++)
     {
 	YCPList list = (l == 0 ? list1 : list2);
@@ -210,10 +210,7 @@ l_unionlist (const YCPList &list1, const YCPList &list2)
 	{
 	    YCPValue to_insert = list->value (e);
 
-	    // Already contained? I know, this has an _awful_ complexity.
-	    // We need to introduce an order on YCPValueRep to solve the problem.
-
-	    if (!newlist->contains(to_insert))
+	    if (contained.insert (to_insert).second)
 		newlist->add (to_insert);
 	}
     }
@@ -605,11 +602,23 @@ l_toset (const YCPList &list)
      * @usage toset ([1, 5, 3, 2, 3, true, false, true]) -> [false, true, 1, 2, 3, 5]
      */
 
-    set<YCPValue, ycp_less> newset(list->begin(), list->end());
+    // drop the duplicates first, only the distinct values need sorting
+    std::unordered_set<YCPValue, ycp_hash, ycp_equal_to> contained;
+    contained.reserve (list->size ());
+
+    vector<YCPValue> distinct;
+    for (YCPList::const_iterator it = list->begin (); it != list->end (); ++it)
+    {
+	if (contained.insert (*it).second)
+	    distinct.push_back (*it);
+    }
+
+    stable_sort (distinct.begin (), distinct.end (), ycp_less ());
 
     YCPList setlist;
-    for (set <YCPValue, ycp_less>::const_iterator it = newset.begin ();
-	 it != newset.end (); ++it)
+    setlist->reserve (distinct.size ());
+    for (vector<YCPValue>::const_iterator it = distinct.begin ();
+	 it != distinct.end (); ++it)
     {
 	setlist->add (*it);
     }
@@ -690,6 +699,75 @@ l_sort (const YCPValue &sym1, const YCPValue &sym2,
 }
 
 
+// orders (key, value) pairs of sort_by by key
+struct sort_key_less
+{
+    bool operator() (const pair<YCPValue, YCPValue>& a, const pair<YCPValue, YCPValue>& b) const
+    {
+	return a.first->compare (b.first) == YO_LESS;
+    }
+};
+
+
+static YCPValue
+l_sort_by (const YCPSymbol &symbol, const YCPList &list, const YCPCode &key)
+{
+    /**
+     * @builtin sort_by
+     * @short Sort list by a key computed for each element
+     * @param any VAR
+     * @param list LIST
+     * @param block EXPR
+     * @return list
+     * @description
+     * For each element of the list <tt>LIST</tt> the expression <tt>EXPR</tt>
+     * is evaluated once, with the variable <tt>VAR</tt> assigned to that
+     * element. The list is sorted by these keys, ascending according to
+     * the YCP builtin predicate. Elements with equal keys keep their order.
+     *
+     * Unlike sort with an expression, which evaluates the expression for
+     * every comparison, the expression is evaluated only once per element.
+     *
+     * @usage sort_by (string s, ["ccc", "a", "bb"], ``(size (s))) -> ["a", "bb", "ccc"]
+     * @usage sort_by (map p, packages, ``(p["name"]:"")) -> packages by name
+     */
+
+    if (list.isNull ())
+    {
+	return YCPNull ();
+    }
+
+    SymbolEntryPtr s = symbol->asEntry()->entry();
+
+    vector<pair<YCPValue, YCPValue> > keyed;
+    keyed.reserve (list->size ());
+
+    for (YCPList::const_iterator it = list->begin(); it != list->end(); ++it)
+    {
+	s->setValue(*it);
+
+	YCPValue k = key->evaluate ();
+	if (k.isNull ())
+	{
+	    ycp2error ("Bad sort_by key %s", key->toString ().c_str ());
+	    return YCPNull ();
+	}
+	keyed.push_back (make_pair (k, *it));
+    }
+
+    stable_sort (keyed.begin (), keyed.end (), sort_key_less ());
+
+    YCPList result;
+    result->reserve (keyed.size ());
+    for (vector<pair<YCPValue, YCPValue> >::const_iterator it = keyed.begin ();
+	 it != keyed.end (); ++it)
+    {
+	result->add (it->second);
+    }
+    return result;
+}
+
+
 static YCPValue
 l_lsortlist (const YCPList &list)
 {
@@ -1294,6 +1372,7 @@ YCPBuiltinList::YCPBuiltinList ()
 	{ "toset",	"list <flex> (const list <flex>)",							(void *)l_toset,	DECL_FLEX,				ETCf },
 	{ "sort",	"list <flex> (const list <flex>)",							(void *)l_sortlist,	DECL_FLEX,                              ETCf },
 	{ "sort",	"list <flex> (variable <flex>, variable <flex>, const list <flex>, const block <boolean>)", (void *)l_sort, 	DECL_SYMBOL|DECL_FLEX,			ETCf },
+	{ "sort_by",	"list <flex1> (variable <flex1>, const list <flex1>, const block <flex2>)",		(void *)l_sort_by,	DECL_SYMBOL|DECL_FLEX,			ETCf },
 	{ "lsort",	"list <flex> (const list <flex>)",							(void *)l_lsortlist,	DECL_FLEX,				ETCf },
 	{ "splitstring","list <string> (string, string)",							(void *)l_splitstring,						 ETC },
 	{ "change", 	"list <flex> (const list <flex>, const flex)",						(void *)l_changelist,	DECL_FLEX|DECL_DEPRECATED,		ETCf },
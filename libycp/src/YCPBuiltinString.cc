@@ -92,9 +92,10 @@ s_size (const YCPString &s)
     if (s.isNull ())
 	return YCPNull ();
 
-    if (s->isAscii())
+    long length = s->length();
+    if (length >= 0)
     {
-	return YCPInteger(s->value().size());
+	return YCPInteger(length);
     }
     else
     {
@@ -308,6 +309,18 @@ s_substring1 (const YCPString &s, const YCPInteger &i1)
 
 	return YCPString(ss.substr((string::size_type) start, string::npos));
     }
+    else if (s->length() >= 0)
+    {
+	long long start = i1->value();
+
+	if (start < 0 || start > s->length())
+	{
+	    ycp2error("Substring index out of range");
+	    return YCPString("");
+	}
+
+	return YCPString(s->value().substr(s->offset(start), string::npos));
+    }
     else
     {
 	wstring ss = s->wvalue();
@@ -363,6 +376,22 @@ s_substring2 (const YCPString &s, const YCPInteger &i1, const YCPInteger &i2)
 
 	return YCPString (ss.substr (start, length));
     }
+    else if (s->length() >= 0)
+    {
+	string::size_type start = i1->value ();
+	string::size_type length = i2->value ();
+	string::size_type size = s->length ();
+
+	if (start > size)
+	{
+	    ycp2error ("Substring index out of range");
+	    return YCPString ("");
+	}
+
+	string::size_type begin = s->offset (start);
+	string::size_type end = length >= size - start ? s->value ().size () : s->offset (start + length);
+	return YCPString (s->value ().substr (begin, end - begin));
+    }
     else
     {
 	wstring ss = s->wvalue();
@@ -421,6 +450,16 @@ s_search (const YCPString &s1, const YCPString &s2)
 	else
 	    return YCPInteger (pos);	// found
     }
+    else if (s1->length() >= 0 && s2->length() >= 0)
+    {
+	// a valid UTF-8 needle can only match at a character boundary
+	string::size_type pos = s1->value ().find (s2->value ());
+
+	if (pos == string::npos)
+	    return YCPVoid ();		// not found
+	else
+	    return YCPInteger (s1->index (pos));	// found
+    }
     else
     {
 	wstring ss1 = s1->wvalue();
@@ -706,6 +745,34 @@ s_mergestring (const YCPList &l, const YCPString &s)
 }
 
 
+/**
+ * find_first_of and friends for valid UTF-8 strings, without converting
+ * them to wstring. Returns the index of the first (or last) character of
+ * s that is (or is not) one of chars, -1 if there is none.
+ */
+static long
+utf8_find_of (const string &s, const string &chars, bool of, bool last)
+{
+    wstring set;
+    for (string::size_type pos = 0; pos < chars.size (); )
+	set += YaST::utf8next (chars, &pos);
+
+    long found = -1;
+    long index = 0;
+    for (string::size_type pos = 0; pos < s.size (); index++)
+    {
+	bool in = set.find (YaST::utf8next (s, &pos)) != wstring::npos;
+	if (in == of)
+	{
+	    found = index;
+	    if (!last)
+		break;
+	}
+    }
+    return found;
+}
+
+
 static YCPValue
 s_findfirstnotof (const YCPString &s1, const YCPString &s2)
 {
@@ -744,6 +811,15 @@ s_findfirstnotof (const YCPString &s1, const YCPString &s2)
 	else
 	    return YCPInteger(pos);	// found
     }
+    else if (s1->length() >= 0 && s2->length() >= 0)
+    {
+	long pos = utf8_find_of(s1->value(), s2->value(), false, false);
+
+	if (pos < 0)
+	    return YCPVoid();		// not found
+	else
+	    return YCPInteger(pos);	// found
+    }
     else
     {
 	wstring::size_type pos = s1->wvalue().find_first_not_of(s2->wvalue());
@@ -792,6 +868,15 @@ s_findfirstof (const YCPString &s1, const YCPString &s2)
 	else
 	    return YCPInteger(pos);	// found
     }
+    else if (s1->length() >= 0 && s2->length() >= 0)
+    {
+	long pos = utf8_find_of(s1->value(), s2->value(), true, false);
+
+	if (pos < 0)
+	    return YCPVoid();		// not found
+	else
+	    return YCPInteger(pos);	// found
+    }
     else
     {
 	wstring::size_type pos = s1->wvalue().find_first_of(s2->wvalue());
@@ -837,6 +922,15 @@ s_findlastof (const YCPString &s1, const YCPString &s2)
 	else
 	    return YCPInteger(pos);	// found
     }
+    else if (s1->length() >= 0 && s2->length() >= 0)
+    {
+	long pos = utf8_find_of(s1->value(), s2->value(), true, true);
+
+	if (pos < 0)
+	    return YCPVoid();		// not found
+	else
+	    return YCPInteger(pos);	// found
+    }
     else
     {
 	wstring::size_type pos = s1->wvalue().find_last_of(s2->wvalue());
@@ -883,6 +977,15 @@ s_findlastnotof (const YCPString &s1, const YCPString &s2)
 	else
 	    return YCPInteger(pos);	// found
     }
+    else if (s1->length() >= 0 && s2->length() >= 0)
+    {
+	long pos = utf8_find_of(s1->value(), s2->value(), false, true);
+
+	if (pos < 0)
+	    return YCPVoid();		// not found
+	else
+	    return YCPInteger(pos);	// found
+    }
     else
     {
 	wstring::size_type pos = s1->wvalue().find_last_not_of(s2->wvalue());
@@ -35,6 +35,21 @@ YCPByteblockRep::YCPByteblockRep (const unsigned char *b, long len)
 }
 
 
+YCPByteblockRep::YCPByteblockRep (unsigned char *b, long len, bool adopt)
+    : len (len)
+{
+    if (adopt)
+    {
+	bytes = b;
+    }
+    else
+    {
+	bytes = new unsigned char [len];
+	memcpy (const_cast<unsigned char *>(bytes), b, len);
+    }
+}
+
+
 YCPByteblockRep::YCPByteblockRep (bytecodeistream & str, long len)
     : len (len)
 {
@@ -81,6 +96,16 @@ YCPByteblockRep::compare (const YCPByteblock& s) const
 }
 
 
+size_t
+YCPByteblockRep::hash() const
+{
+    size_t h = len;
+    for (long i=0; i<len; i++)
+	h = h * 31 + bytes[i];
+    return h;
+}
+
+
 inline char
 tohex(int n)
 {
@@ -19,6 +19,7 @@
 
 #include <ctype.h>
 #include <sstream>
+#include <functional>
 
 #include "ycp/y2log.h"
 #include "ycp/YCPFloat.h"
@@ -70,6 +71,14 @@ YCPFloatRep::compare(const YCPFloat& f) const
 }
 
 
+size_t
+YCPFloatRep::hash() const
+{
+    // 0.0 == -0.0
+    return v == 0.0 ? 0 : std::hash<double>() (v);
+}
+
+
 string
 YCPFloatRep::toString() const
 {
@@ -18,6 +18,8 @@
 
 /-*/
 
+#include <functional>
+
 #include "ycp/y2log.h"
 #include "ycp/YCPInteger.h"
 #include "ycp/Bytecode.h"
@@ -76,6 +78,13 @@ YCPIntegerRep::compare(const YCPInteger& i) const
 }
 
 
+size_t
+YCPIntegerRep::hash() const
+{
+    return std::hash<long long>() (v);
+}
+
+
 string
 YCPIntegerRep::toString() const
 {
@@ -138,7 +147,26 @@ static long long fromStream (bytecodeistream & str)
     return ll;
 }
 
+YCPInteger* YCPInteger::smallintegers[SMALL_MAX - SMALL_MIN + 1];
+
+const YCPIntegerRep *
+YCPInteger::smallInteger (long long v)
+{
+    if (!sharing ())
+    {
+	return new YCPIntegerRep (v);
+    }
+
+    YCPInteger *&i = smallintegers[v - SMALL_MIN];
+    if (i == NULL)
+    {
+	i = new YCPInteger (new YCPIntegerRep (v));
+    }
+    return static_cast<const YCPIntegerRep *>(i->element);
+}
+
+
 YCPInteger::YCPInteger (bytecodeistream & str)
-    : YCPValue (new YCPIntegerRep (fromStream (str)))
+    : YCPValue (YCPInteger (fromStream (str)))
 {
 }
@@ -23,10 +23,12 @@
 #include "ycp/y2log.h"
 #include "ycp/YCPList.h"
 #include <algorithm>
+#include <wchar.h>
 #include "ycp/Bytecode.h"
 #include "ycp/Xmlcode.h"
 #include "ycp/YCPCodeCompare.h"
 #include "ycp/ExecutionEnvironment.h"
+#include "ycp/y2string.h"
 
 
 // YCPListRep
@@ -126,10 +128,63 @@ YCPListRep::sortlist()
 }
 
 
+// an element of lsortlist, strings carry their collation key
+struct lsort_item
+{
+    YCPValue value;
+    std::wstring key;
+    bool keyed;
+
+    lsort_item (const YCPValue& v) : value (v), keyed (false) {}
+};
+
+
+// wcsxfrm keys compare like wcscoll does on the strings
+static bool
+collation_key (const YCPString& s, std::wstring* key)
+{
+    std::wstring w;
+    if (!YaST::utf82wchar (s->value (), &w))
+	return false;
+
+    size_t n = wcsxfrm (NULL, w.c_str (), 0);
+    key->resize (n + 1);
+    wcsxfrm (&(*key)[0], w.c_str (), n + 1);
+    key->resize (n);
+    return true;
+}
+
+
+struct lsort_less
+{
+    bool operator() (const lsort_item& a, const lsort_item& b) const
+    {
+	if (a.keyed && b.keyed)
+	    return a.key < b.key;
+	// not both valid UTF-8 strings, YCPStringRep::compare falls back to strcoll
+	return a.value->compare (b.value, true) == YO_LESS;
+    }
+};
+
+
 void
 YCPListRep::lsortlist()
 {
-    std::sort(elements.begin(), elements.end(), ycp_less(true));
+    // wcscoll is expensive, transform each string once
+    // instead of in every comparison
+    std::vector<lsort_item> items;
+    items.reserve (elements.size ());
+    for (const_iterator it = elements.begin (); it != elements.end (); ++it)
+    {
+	items.push_back (lsort_item (*it));
+	if ((*it)->isString ())
+	    items.back ().keyed = collation_key ((*it)->asString (), &items.back ().key);
+    }
+
+    std::sort (items.begin (), items.end (), lsort_less ());
+
+    for (size_t i = 0; i < items.size (); ++i)
+	elements[i] = items[i].value;
 }
 
 
@@ -241,6 +296,16 @@ YCPListRep::compare(const YCPList& l) const
     }
 }
 
+
+size_t
+YCPListRep::hash() const
+{
+    size_t h = elements.size();
+    for (unsigned i = 0; i < elements.size(); i++)
+	h = h * 31 + elements[i]->hash();
+    return h;
+}
+
 string
 YCPListRep::toString() const
 {
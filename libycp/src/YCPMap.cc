@@ -24,11 +24,91 @@
 #include "ycp/Xmlcode.h"
 #include "ycp/ExecutionEnvironment.h"
 
+#include <unordered_map>
+
+
+// key of the string index: the hash cached in the YCPStringRep and
+// the string of the key in stl_map
+
+struct index_key_t
+{
+    size_t hash;
+    const string *str;
+};
+
+struct index_key_hash
+{
+    size_t operator() (const index_key_t &k) const { return k.hash; }
+};
+
+struct index_key_equal
+{
+    bool operator() (const index_key_t &a, const index_key_t &b) const
+    {
+	return a.hash == b.hash && *a.str == *b.str;
+    }
+};
+
+class YCPMapIndex
+    : public std::unordered_map<index_key_t, YCPValueYCPValueMap::const_iterator, index_key_hash, index_key_equal>
+{
+};
+
+
+static inline index_key_t
+indexKey (const YCPValue & key)
+{
+    // the string stays valid, key refers to the same YCPStringRep
+    YCPString s = key->asString ();
+    index_key_t k = { s->hash (), &s->value () };
+    return k;
+}
+
 
 // YCPMapRep
 
 YCPMapRep::YCPMapRep()
+    : string_index (0)
+    , lookups (0)
+{
+}
+
+
+YCPMapRep::~YCPMapRep()
 {
+    delete string_index;
+}
+
+
+YCPValueYCPValueMap::const_iterator
+YCPMapRep::find (const YCPValue& key) const
+{
+    if (!key->isString ())
+    {
+	return stl_map.find (key);
+    }
+
+    if (string_index == 0)
+    {
+	if (stl_map.size () < INDEX_THRESHOLD
+	    || ++lookups < INDEX_THRESHOLD)
+	{
+	    return stl_map.find (key);
+	}
+
+	string_index = new YCPMapIndex;
+	string_index->reserve (stl_map.size ());
+	for (YCPValueYCPValueMap::const_iterator pos = stl_map.begin (); pos != stl_map.end (); ++pos)
+	{
+	    if (pos->first->isString ())
+	    {
+		string_index->insert (std::make_pair (indexKey (pos->first), pos));
+	    }
+	}
+    }
+
+    YCPMapIndex::const_iterator it = string_index->find (indexKey (key));
+    return it == string_index->end () ? stl_map.end () : it->second;
 }
 
 
@@ -69,7 +149,11 @@ YCPMapRep::add (const YCPValue& key, const YCPValue& value)
     else
     {
 	// pos is just a hint but can avoid a second search through the map
-	stl_map.insert(pos, YCPMap::value_type(key, value));
+	pos = stl_map.insert(pos, YCPMap::value_type(key, value));
+	if (string_index && key->isString())
+	{
+	    string_index->insert(std::make_pair(indexKey(pos->first), YCPMap::const_iterator(pos)));
+	}
     }
 
 }
@@ -108,6 +192,18 @@ void YCPMapRep::remove(const YCPValue& key)
         return;
     }
 
+    if (string_index && key->isString())
+    {
+	YCPMapIndex::iterator it = string_index->find (indexKey (key));
+	if (it != string_index->end ())
+	{
+	    YCPMap::const_iterator pos = it->second;
+	    string_index->erase (it);
+	    stl_map.erase (pos);
+	}
+	return;
+    }
+
     stl_map.erase (key);
 }
 
@@ -140,14 +236,14 @@ YCPMapRep::size() const
 bool
 YCPMapRep::hasKey(const YCPValue& key) const
 {
-    return stl_map.find(key) != stl_map.end();
+    return find(key) != stl_map.end();
 }
 
 
 YCPValue
 YCPMapRep::value(const YCPValue& key) const
 {
-    YCPMap::const_iterator pos = stl_map.find(key);
+    YCPMap::const_iterator pos = find(key);
 
     if (pos != end())
 	return pos->second;
@@ -198,6 +294,19 @@ YCPMapRep::compare(const YCPMap& m) const
 }
 
 
+size_t
+YCPMapRep::hash() const
+{
+    size_t h = stl_map.size();
+    for (YCPMap::const_iterator pos = begin(); pos != end(); ++pos)
+    {
+	h = h * 31 + pos->first->hash();
+	h = h * 31 + pos->second->hash();
+    }
+    return h;
+}
+
+
 string
 YCPMapRep::toString() const
 {
@@ -267,6 +376,11 @@ YCPMap::YCPMap(bytecodeistream & str)
 	{
 	    YCPValue key = Bytecode::readValue (str);
 	    YCPValue value = Bytecode::readValue (str);
+	    // keys repeat across maps of the same kind, share them
+	    if (!key.isNull () && key->isString ())
+	    {
+		key = YCPString::intern (key->asString ()->value ());
+	    }
 	    (*this)->add (key, value);
 	}
     }
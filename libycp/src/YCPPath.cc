@@ -17,6 +17,8 @@
 
 /-*/
 
+#include <functional>
+
 #include "ycp/y2log.h"
 #include "ycp/YCPPath.h"
 #include "ycp/Bytecode.h"
@@ -180,6 +182,16 @@ YCPPathRep::compare(const YCPPath& p) const
 }
 
 
+size_t
+YCPPathRep::hash() const
+{
+    size_t h = components.size();
+    for (unsigned c=0; c<components.size(); c++)
+	h = h * 31 + std::hash<string>() (components[c].component.asString());
+    return h;
+}
+
+
 string
 YCPPathRep::toString() const
 {
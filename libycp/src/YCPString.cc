@@ -19,6 +19,8 @@
 /-*/
 
 #include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 #include "y2string.h"
 
@@ -31,20 +33,55 @@
 // YCPStringRep
 
 YCPStringRep::YCPStringRep(const string& s)
-    : v(s), is_ascii(false)
+    : v(s), is_ascii(false), hash_value(0), char_count(-2), char_offsets(0)
+{
+    is_ascii = all_of(v.begin(), v.end(), isascii);
+}
+
+
+YCPStringRep::YCPStringRep(string&& s)
+    : v(std::move(s)), is_ascii(false), hash_value(0), char_count(-2), char_offsets(0)
 {
     is_ascii = all_of(v.begin(), v.end(), isascii);
 }
 
 
 YCPStringRep::YCPStringRep(const wstring& s)
-    : v(), is_ascii(false)
+    : v(), is_ascii(false), hash_value(0), char_count(-2), char_offsets(0)
 {
     YaST::wchar2utf8(s, &v);
     is_ascii = all_of(v.begin(), v.end(), isascii);
 }
 
 
+YCPStringRep::~YCPStringRep()
+{
+    delete char_offsets;
+}
+
+
+void
+YCPStringRep::append(const string& s)
+{
+    // std::string grows its capacity geometrically
+    v += s;
+    is_ascii = is_ascii && all_of(s.begin(), s.end(), isascii);
+
+    // forget everything computed from the old value
+    hash_value = 0;
+    char_count = -2;
+    delete char_offsets;
+    char_offsets = 0;
+}
+
+
+const YCPElementRep*
+YCPStringRep::shallowCopy() const
+{
+    return new YCPStringRep(v);
+}
+
+
 bool
 YCPStringRep::isEmpty() const
 {
@@ -59,6 +96,94 @@ YCPStringRep::value() const
 }
 
 
+size_t
+YCPStringRep::hash() const
+{
+    if (hash_value == 0)
+    {
+	hash_value = std::hash<string>() (v);
+	if (hash_value == 0)
+	    hash_value = 1;
+    }
+    return hash_value;
+}
+
+
+long
+YCPStringRep::length() const
+{
+    if (is_ascii)
+	return v.size();
+
+    if (char_count == -2)
+	char_count = YaST::utf8length(v);
+    return char_count;
+}
+
+
+string::size_type
+YCPStringRep::offset(long index) const
+{
+    if (is_ascii)
+	return index;
+
+    if (index >= length())
+	return v.size();
+
+    string::size_type pos = 0;
+    long skip = index;
+
+    if (length() >= 2 * CHAR_STEP)
+    {
+	if (char_offsets == 0)
+	{
+	    char_offsets = new vector<string::size_type>;
+	    char_offsets->reserve(char_count / CHAR_STEP + 1);
+	    for (long i = 0; pos < v.size(); i++)
+	    {
+		if (i % CHAR_STEP == 0)
+		    char_offsets->push_back(pos);
+		YaST::utf8next(v, &pos);
+	    }
+	}
+
+	pos = (*char_offsets)[index / CHAR_STEP];
+	skip = index % CHAR_STEP;
+    }
+
+    while (skip-- > 0 && pos < v.size())
+	YaST::utf8next(v, &pos);
+    return pos;
+}
+
+
+long
+YCPStringRep::index(string::size_type offset) const
+{
+    if (is_ascii)
+	return offset;
+
+    long ret = 0;
+    string::size_type pos = 0;
+
+    if (length() >= 2 * CHAR_STEP)
+    {
+	// let offset() build the index
+	this->offset(0);
+	vector<string::size_type>::const_iterator it =
+	    upper_bound(char_offsets->begin(), char_offsets->end(), offset) - 1;
+	ret = (it - char_offsets->begin()) * CHAR_STEP;
+	pos = *it;
+    }
+
+    // count the characters, that is the bytes that are no continuation bytes
+    for (; pos < offset; pos++)
+	if ((v[pos] & 0xc0) != 0x80)
+	    ret++;
+    return ret;
+}
+
+
 wstring
 YCPStringRep::wvalue() const
 {
@@ -170,6 +295,64 @@ fromStream (bytecodeistream & str)
 
 
 YCPString::YCPString (bytecodeistream & str)
-    : YCPValue (new YCPStringRep (fromStream (str)))
+    : YCPValue (YCPString (fromStream (str)))
+{
+}
+
+
+YCPString* YCPString::emptystring = NULL;
+
+const YCPStringRep *
+YCPString::emptyString ()
+{
+    if (!sharing ())
+    {
+	return new YCPStringRep (string ());
+    }
+
+    if (emptystring == NULL)
+    {
+	emptystring = new YCPString (new YCPStringRep (string ()));
+    }
+    return static_cast<const YCPStringRep *>(emptystring->element);
+}
+
+
+YCPString
+YCPString::intern (const string & s)
+{
+    if (s.size () > INTERN_MAX_LENGTH || !sharing ())
+    {
+	return YCPString (s);
+    }
+
+    // never freed, may be used by static destructors
+    static std::unordered_map<string, YCPString> *table = new std::unordered_map<string, YCPString>;
+
+    std::unordered_map<string, YCPString>::const_iterator it = table->find (s);
+    if (it != table->end ())
+    {
+	return it->second;
+    }
+
+    YCPString result (s);
+    if (table->size () < INTERN_MAX_COUNT)
+    {
+	table->insert (std::make_pair (s, result));
+    }
+    return result;
+}
+
+
+void
+YCPString::append (const string & s)
 {
+    if (s.empty ())
+    {
+	return;
+    }
+
+    // the empty and the interned strings are always shared,
+    // writeCopy copies them like any other shared value
+    const_cast<YCPStringRep *>(static_cast<const YCPStringRep *>(writeCopy ()))->append (s);
 }
@@ -17,6 +17,8 @@
 
 /-*/
 
+#include <functional>
+
 #include "ycp/y2log.h"
 #include "ycp/YCPSymbol.h"
 #include "ycp/Bytecode.h"
@@ -59,6 +61,13 @@ YCPSymbolRep::compare(const YCPSymbol& s) const
 }
 
 
+size_t
+YCPSymbolRep::hash() const
+{
+    return std::hash<string>() (v.asString());
+}
+
+
 string
 YCPSymbolRep::toString() const
 {
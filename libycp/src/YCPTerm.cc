@@ -19,6 +19,8 @@
 
 /-*/
 
+#include <functional>
+
 #include "ycp/y2log.h"
 #include "ycp/YCPTerm.h"
 #include "ycp/Bytecode.h"
@@ -73,6 +75,13 @@ YCPTermRep::compare (const YCPTerm& t) const
 }
 
 
+size_t
+YCPTermRep::hash() const
+{
+    return std::hash<string>() (name()) * 31 + l->hash();
+}
+
+
 // clone term
 const YCPElementRep*
 YCPTermRep::shallowCopy() const
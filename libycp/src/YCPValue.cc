@@ -19,6 +19,8 @@
 
 /-*/
 
+#include <stdlib.h>
+
 #include "ycp/y2log.h"
 #include "ycp/ExecutionEnvironment.h"
 
@@ -306,6 +308,12 @@ YCPValueRep::compare (const YCPValue& v, bool rl) const
     return valuetype() < v->valuetype() ? YO_LESS : YO_GREATER;
 }
 
+size_t
+YCPValueRep::hash () const
+{
+    return valuetype ();
+}
+
 /**
  * Default constructor, sets the value to YCPNull().
  */
@@ -313,6 +321,14 @@ YCPValue::YCPValue ()
     : YCPElement ()
 {}
 
+
+bool
+YCPValue::sharing ()
+{
+    static const bool share = (getenv ("Y2NOSHARING") == 0);
+    return share;
+}
+
 // FIXME: remove this in the future
 YCPValue YCPError (string message, const YCPValue & ret)
 {
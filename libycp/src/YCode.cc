@@ -501,6 +501,8 @@ YLocale::t_uniquedomains YLocale::domains;
 YLocale::YLocale (const char *locale, const char *textdomain)
     : YCode ()
     , m_locale (locale)
+    , m_translation (YCPNull ())
+    , m_generation (0)
 {
     if (domains.find (textdomain) == domains.end ())
     {
@@ -513,6 +515,8 @@ YLocale::YLocale (const char *locale, const char *textdomain)
 
 YLocale::YLocale (bytecodeistream & str)
     : YCode ()
+    , m_translation (YCPNull ())
+    , m_generation (0)
 {
     m_locale = Bytecode::readCharp (str);		// the string to be translated
 
@@ -582,11 +586,27 @@ YLocale::evaluate (bool cse)
 {
     if (cse) return YCPNull();
 
+    int generation = catalogGeneration ();
+    if (!m_translation.isNull () && m_generation == generation)
+    {
+	return m_translation;
+    }
+
     const char *ret = dgettext (m_domain->first, m_locale);
 #if DO_DEBUG
     y2debug ("localize <%s> to <%s>", m_locale, ret);
 #endif
-    return YCPString (ret);
+    m_translation = YCPString (ret);
+    m_generation = generation;
+    return m_translation;
+}
+
+
+int
+YLocale::catalogGeneration ()
+{
+    extern int _nl_msg_cat_cntr;
+    return _nl_msg_cat_cntr;
 }
 
 // FIXME: why we use pair string:bool in domains if we used only true value?
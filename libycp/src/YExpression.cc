@@ -35,6 +35,8 @@
 #include "ycp/YCPVoid.h"
 #include "ycp/YExpression.h"
 #include "ycp/SymbolTable.h"
+#include "ycp/ThreadedCode.h"
+#include "ycp/Profiler.h"
 
 #include "ycp/Bytecode.h"
 #include "ycp/Xmlcode.h"
@@ -424,12 +426,14 @@ YECompare::YECompare (YCodePtr left, c_op op, YCodePtr right)
     , m_left (left)
     , m_op (op)
     , m_right (right)
+    , m_threaded (0)
 {
 }
 
 
 YECompare::YECompare (bytecodeistream & str)
     : YCode ()
+    , m_threaded (0)
 {
     m_left = Bytecode::readCode (str);
     char c;
@@ -441,6 +445,7 @@ YECompare::YECompare (bytecodeistream & str)
 
 YECompare::~YECompare ()
 {
+    delete m_threaded;
 }
 
 static string
@@ -481,12 +486,28 @@ YECompare::evaluate (bool cse)
 	return YCPNull();
     }
 
+    if (m_threaded == 0 && ThreadedCode::enabled ())
+    {
+	m_threaded = ThreadedCode::compile (this);
+    }
+    if (m_threaded)
+    {
+	return m_threaded->evaluate ();
+    }
+
     YCPValue vl = m_left->evaluate (cse);
     YCPValue vr = m_right->evaluate (cse);
 #if DO_DEBUG
     y2debug ("YECompare::evaluate (%s, '%d', %s)", vl.isNull() ? "NULL" : vl->toString().c_str(), m_op, vr.isNull() ? "NULL" : vr->toString().c_str());
 #endif
 
+    return compare (vl, m_op, vr);
+}
+
+
+YCPValue
+YECompare::compare (const YCPValue & vl, c_op m_op, const YCPValue & vr)
+{
     if ( (vl.isNull () || vl->isVoid () || vr.isNull () || vr->isVoid ()) && (m_op != C_EQ && m_op != C_NEQ) )	// nil can be compared only for (n)equality
     {
 	ycp2error ("Nil can be compared only for equality and non-equality");
@@ -563,6 +584,9 @@ YELocale::YELocale (const char *singular, const char *plural, YCodePtr count, co
     , m_singular (singular)
     , m_plural (plural)
     , m_count (count)
+    , m_translation (YCPNull ())
+    , m_translated_count (0)
+    , m_generation (0)
 {
     if (YLocale::domains.find (textdomain) == YLocale::domains.end ())
     {
@@ -574,6 +598,9 @@ YELocale::YELocale (const char *singular, const char *plural, YCodePtr count, co
 
 YELocale::YELocale (bytecodeistream & str)
     : YCode ()
+    , m_translation (YCPNull ())
+    , m_translated_count (0)
+    , m_generation (0)
 {
     m_singular = Bytecode::readCharp (str);		// text for singular
     m_plural = Bytecode::readCharp (str);		// text for plural
@@ -636,13 +663,23 @@ YELocale::evaluate (bool cse)
 	return YCPNull ();
     }
 
-    const char *ret = dngettext (m_domain->first, m_singular, m_plural, count->asInteger()->value());
+    long long n = count->asInteger()->value();
+    int generation = YLocale::catalogGeneration ();
+    if (!m_translation.isNull () && m_translated_count == n && m_generation == generation)
+    {
+	return m_translation;
+    }
+
+    const char *ret = dngettext (m_domain->first, m_singular, m_plural, n);
 
 #if DO_DEBUG
-    y2debug ("localize <%s, %s, %d> to <%s>", m_singular, m_plural, (int)(count->asInteger()->value()), ret);
+    y2debug ("localize <%s, %s, %d> to <%s>", m_singular, m_plural, (int)n, ret);
 #endif
 
-    return YCPString (ret);
+    m_translation = YCPString (ret);
+    m_translated_count = n;
+    m_generation = generation;
+    return m_translation;
 }
 
 
@@ -1211,8 +1248,8 @@ std::ostream &
 YEPropagate::toStream (std::ostream & str) const
 {
     YCode::toStream (str);
-    m_from->toStream (str);
-    m_to->toStream (str);
+    Bytecode::writeType (str, m_from);
+    Bytecode::writeType (str, m_to);
     return m_value->toStream (str);
 }
 
@@ -1235,12 +1272,14 @@ YEUnary::YEUnary (declaration_t *decl, YCodePtr arg)
     : YCode ()
     , m_decl (decl)
     , m_arg (arg)
+    , m_threaded (0)
 {
 }
 
 
 YEUnary::YEUnary (bytecodeistream & str)
     : YCode ()
+    , m_threaded (0)
 {
     extern StaticDeclaration static_declarations;
 
@@ -1254,6 +1293,7 @@ YEUnary::YEUnary (bytecodeistream & str)
 
 YEUnary::~YEUnary ()
 {
+    delete m_threaded;
 }
 
 
@@ -1283,6 +1323,15 @@ YEUnary::evaluate (bool cse)
 	return YCPNull();
     }
 
+    if (m_threaded == 0 && ThreadedCode::enabled ())
+    {
+	m_threaded = ThreadedCode::compile (this);
+    }
+    if (m_threaded)
+    {
+	return m_threaded->evaluate ();
+    }
+
     YCPValue arg = m_arg->evaluate ();
     const declaration_t *decl = m_decl;
 
@@ -1339,12 +1388,14 @@ YEBinary::YEBinary (declaration_t *decl, YCodePtr arg1, YCodePtr arg2)
     , m_decl (decl)
     , m_arg1 (arg1)
     , m_arg2 (arg2)
+    , m_threaded (0)
 {
 }
 
 
 YEBinary::YEBinary (bytecodeistream & str)
     : YCode ()
+    , m_threaded (0)
 {
     extern StaticDeclaration static_declarations;
 
@@ -1359,6 +1410,7 @@ YEBinary::YEBinary (bytecodeistream & str)
 
 YEBinary::~YEBinary ()
 {
+    delete m_threaded;
 }
 
 
@@ -1392,6 +1444,15 @@ YEBinary::evaluate (bool cse)
 	return (*(v2vv)m_decl->ptr) (YCPCode(m_arg1), YCPCode (m_arg2));
     }
 
+    if (m_threaded == 0 && ThreadedCode::enabled ())
+    {
+	m_threaded = ThreadedCode::compile (this);
+    }
+    if (m_threaded)
+    {
+	return m_threaded->evaluate ();
+    }
+
     const YCPValue arg1 = m_arg1->evaluate ();
     if ((arg1.isNull() || arg1->isVoid())
 	&& ((m_decl->flags & DECL_NIL) == 0))
@@ -1422,6 +1483,124 @@ YEBinary::evaluate (bool cse)
 }
 
 
+// is decl the string (string, string) addition?
+
+static bool
+isStringPlus (const declaration_t *decl)
+{
+    if (decl == 0 || strcmp (decl->name, "+") != 0)
+    {
+	return false;
+    }
+    constFunctionTypePtr type = decl->type;
+    return type->returnType ()->isString ()
+	&& type->parameterCount () == 2
+	&& type->parameterType (0)->isString ()
+	&& type->parameterType (1)->isString ();
+}
+
+
+YEBinary *
+YEBinary::stringAppend (YCodePtr code, SymbolEntryPtr entry)
+{
+    YCode *node = code.operator-> ();
+    int count = 0;
+    while (node->kind () == yeBinary
+	   && isStringPlus (static_cast<YEBinary *> (node)->m_decl))
+    {
+	if (++count > MAX_APPEND)
+	{
+	    return 0;
+	}
+	node = static_cast<YEBinary *> (node)->m_arg1.operator-> ();
+    }
+
+    if (count == 0
+	|| node->kind () != yeVariable
+	|| static_cast<YEVariable *> (node)->entry () != entry)
+    {
+	return 0;
+    }
+    return static_cast<YEBinary *> (code.operator-> ());
+}
+
+
+YCPValue
+YEBinary::evaluateAppend (SymbolEntryPtr entry)
+{
+    // the additions, outermost first
+    YEBinary *chain[MAX_APPEND];
+    int count = 0;
+    YEBinary *node = this;
+    for (;;)
+    {
+	chain[count++] = node;
+	if (node->m_arg1->kind () != yeBinary)
+	{
+	    break;
+	}
+	node = static_cast<YEBinary *> (node->m_arg1.operator-> ());
+    }
+
+    // evaluate all operands before changing anything, they may refer
+    // to the variable. On nil report what the nested YEBinary::evaluate
+    // calls would have reported.
+    YCPValue operands[MAX_APPEND];
+    YCPValue value = node->m_arg1->evaluate ();
+    int i = count - 1;
+    if (value.isNull () || value->isVoid ())
+    {
+	ycp2error ("Argument (%s) to %s(...) evaluates to nil", node->m_arg1->toString().c_str(), node->m_decl->name);
+    }
+    else
+    {
+	for (; i >= 0; --i)
+	{
+	    operands[i] = chain[i]->m_arg2->evaluate ();
+	    if (operands[i].isNull () || operands[i]->isVoid ())
+	    {
+		ycp2error ("Argument (%s) to %s(...) evaluates to nil", chain[i]->m_arg2->toString().c_str(), chain[i]->m_decl->name);
+		break;
+	    }
+	}
+    }
+    if (i >= 0)
+    {
+	while (--i >= 0)
+	{
+	    ycp2error ("Argument (%s) to %s(...) evaluates to nil", chain[i]->m_arg1->toString().c_str(), chain[i]->m_decl->name);
+	}
+	return YCPNull ();
+    }
+
+    bool strings = value->isString ();
+    for (i = 0; i < count && strings; ++i)
+    {
+	strings = operands[i]->isString ();
+    }
+    if (!strings)
+    {
+	for (i = count - 1; i >= 0 && !value.isNull (); --i)
+	{
+	    value = (*(v2vv)chain[i]->m_decl->ptr) (value, operands[i]);
+	}
+	return value;
+    }
+
+    YCPString result = value->asString ();
+    value = YCPNull ();
+    // drop the reference of the variable, the caller assigns the
+    // result to it anyway
+    entry->setValue (YCPVoid ());
+
+    for (i = count - 1; i >= 0; --i)
+    {
+	result.append (operands[i]->asString ()->value ());
+    }
+    return result;
+}
+
+
 std::ostream &
 YEBinary::toStream (std::ostream & str) const
 {
@@ -1658,7 +1837,7 @@ std::ostream &
 YEIs::toStream (std::ostream & str) const
 {
     YCode::toStream (str);
-    m_type->toStream (str);
+    Bytecode::writeType (str, m_type);
     return m_expr->toStream (str);
 }
 
@@ -1889,7 +2068,7 @@ YEBracket::toStream (std::ostream & str) const
     m_var->toStream (str);
     m_arg->toStream (str);
     m_def->toStream (str);
-    return m_resultType->toStream (str);
+    return Bytecode::writeType (str, m_resultType);
 }
 
 
@@ -2562,6 +2741,10 @@ YEBuiltin::evaluate (bool cse)
 	return ret;
     }
 
+    YaST::CallTimer timer;
+    if (YaST::CallStats::enabled ())
+	timer.start (YaST::CallStats::builtin (m_decl));
+
     if (m_decl->name_space && ( m_decl->name_space->flags & DECL_CALL_HANDLER ) )
     {
 	// The bultin belongs to a name space with a special call handler -
@@ -3126,7 +3309,9 @@ YEFunction::evaluate (bool cse)
 	}
     }
 
-    YCPValue* evaluated_params = new YCPValue[m_next_param_id];
+    // most functions have few parameters, keep them on the stack then
+    YCPValue local_params[LOCAL_PARAMS];
+    YCPValue* evaluated_params = m_next_param_id <= LOCAL_PARAMS ? local_params : new YCPValue[m_next_param_id];
 
     for (unsigned int p = 0; p < m_next_param_id ; p++)
     {
@@ -3137,7 +3322,8 @@ YEFunction::evaluate (bool cse)
 	if (value.isNull())
 	{
 	    ycp2error ("Parameter eval failed (%s)", m_parameters[p]->toString().c_str());
-            delete[](evaluated_params);
+	    if (evaluated_params != local_params)
+		delete[](evaluated_params);
 	    return value;
 	}
 
@@ -3156,26 +3342,32 @@ YEFunction::evaluate (bool cse)
 
     // save the context info
     int linenumber = YaST::ee.linenumber();
-    string filename = YaST::ee.filename();
+    const string* filename = YaST::ee.filenamePtr();
 
     if (YaST::ee.endlessRecursion())
     {
 	ycp2error ("Returning nil instead of calling the function.");
-        delete[](evaluated_params);
+	if (evaluated_params != local_params)
+	    delete[](evaluated_params);
 	return YCPVoid ();
     }
 
     YaST::ee.pushframe((YECallPtr)this, evaluated_params);
 
+    YaST::CallTimer timer;
+    if (YaST::CallStats::enabled ())
+	timer.start (YaST::CallStats::function (m_sentry.operator-> ()));
+
     YCPValue value = m_functioncall->evaluateCall ();
 
     // restore the context info
     YaST::ee.setLinenumber(linenumber);
-    YaST::ee.setFilename(filename);
+    YaST::ee.setFilenamePtr(filename);
 
     YaST::ee.popframe();
     // FIXME: did the frame need ep to exist? otherwise we could delete it before evaluateCall
-    delete[](evaluated_params);
+    if (evaluated_params != local_params)
+	delete[](evaluated_params);
 
 #if DO_DEBUG
     y2debug("evaluate done (%s) = '%s'", qualifiedName ().c_str(), value.isNull() ? "NULL" : value->toString().c_str());
@@ -3301,13 +3493,17 @@ YEFunctionPointer::evaluate (bool cse)
 
     // save the context info
     int linenumber = YaST::ee.linenumber();
-    string filename = YaST::ee.filename();
+    const string* filename = YaST::ee.filenamePtr();
+
+    YaST::CallTimer timer;
+    if (YaST::CallStats::enabled ())
+	timer.start (YaST::CallStats::function (ptr_sentry.operator-> ()));
 
     YCPValue value = m_functioncall->evaluateCall ();
 
     // restore the context info
     YaST::ee.setLinenumber(linenumber);
-    YaST::ee.setFilename(filename);
+    YaST::ee.setFilenamePtr(filename);
 
 #if DO_DEBUG
     y2debug("evaluate done (%s) = '%s'", qualifiedName ().c_str(), value.isNull() ? "NULL" : value->toString().c_str());
@@ -3402,7 +3598,7 @@ Y2YCPFunction::evaluateCall ()
 
     // save the context info
     int linenumber = YaST::ee.linenumber();
-    string filename = YaST::ee.filename();
+    const string* filename = YaST::ee.filenamePtr();
 
     YCPValue value = definition->evaluate ();
 
@@ -3414,7 +3610,7 @@ Y2YCPFunction::evaluateCall ()
 
     // restore the context info
     YaST::ee.setLinenumber(linenumber);
-    YaST::ee.setFilename(filename);
+    YaST::ee.setFilenamePtr(filename);
 
     // pop parameter values for recursion
     for (unsigned int p = 0; p < func->parameterCount(); p++)
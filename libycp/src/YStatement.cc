@@ -593,7 +593,7 @@ YSTypedef::toStream (std::ostream & str) const
 {
     YStatement::toStream (str);
     Bytecode::writeUstring (str, m_name);
-    return m_type->toStream (str);
+    return Bytecode::writeType (str, m_type);
 }
 
 
@@ -625,15 +625,21 @@ YSAssign::YSAssign (SymbolEntryPtr entry, YCodePtr code, int line)
     : YStatement (line)
     , m_entry (entry)
     , m_code (code)
+    , m_append (0)
 {
+    if (m_entry && m_code)
+	m_append = YEBinary::stringAppend (m_code, m_entry);
 }
 
 
 YSAssign::YSAssign (bytecodeistream & str)
     : YStatement (str)
+    , m_append (0)
 {
     m_entry = Bytecode::readEntry (str);
     m_code = Bytecode::readCode (str);
+    if (m_entry && m_code)
+	m_append = YEBinary::stringAppend (m_code, m_entry);
 }
 
 
@@ -683,7 +689,8 @@ YSAssign::evaluate (bool cse)
 #if DO_DEBUG
     y2debug ("YSAssign::evaluate(%s)\n", toString().c_str());
 #endif
-    YCPValue value = m_code->evaluate ();
+    // s = s + x appends to the value of s in place
+    YCPValue value = m_append ? m_append->evaluateAppend (m_entry) : m_code->evaluate ();
     m_entry->setValue (value.isNull() ? YCPVoid() : value);
 #if DO_DEBUG
     y2debug ("YSAssign::evaluate (%s) = '%s'\n", m_code->toString().c_str(), value.isNull() ? "NULL" : value->toString().c_str());
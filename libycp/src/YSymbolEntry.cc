@@ -242,7 +242,7 @@ YSymbolEntry::toStream (std::ostream & str) const
     Bytecode::writeInt32 (str, m_position);
     Bytecode::writeCharp (str, m_name.asString().c_str());
     Bytecode::writeInt32 (str, m_category);
-    m_type->toStream (str);
+    Bytecode::writeType (str, m_type);
 #if 0
     if (m_category == c_variable)
     {
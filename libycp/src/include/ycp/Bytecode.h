@@ -35,6 +35,7 @@ class Y2Namespace;
 #include <iosfwd>
 #include <string>
 #include <map>
+#include <vector>
 
 #include <fstream>
 
@@ -48,14 +49,26 @@ class Y2Namespace;
 class bytecodeistream : public std::ifstream
 {
 	int m_major, m_minor, m_release;
+	bool m_compact;
+	/// strings and types of a compact stream, by pool index
+	std::vector<string> m_strings;
+	std::vector<TypePtr> m_types;
+	void readHeader (const char * header, const string & name);
     public:
 	bytecodeistream (string filename);
+	/// read from buf, which starts with header and the version
+	bytecodeistream (std::streambuf * buf, const char * header, const string & name);
 	bool isVersion (int major, int minor, int revision);
 	bool isVersionAtMost (int major, int minor, int revision);
 	
 	int major () const { return m_major; }
 	int minor () const { return m_minor; }
 	int release () const { return m_release; }
+
+	/// since 1.5.0: varints and a string and type pool
+	bool isCompact () const { return m_compact; }
+	std::vector<string> & stringPool () { return m_strings; }
+	std::vector<TypePtr> & typePool () { return m_types; }
 };
 
 /// *.ybc I/O
@@ -72,6 +85,8 @@ class Bytecode {
     static namespaceentry_t *m_namespace_nesting_array;
     static map<string, YBlockPtr>* m_bytecodeCache;
 
+    static TypePtr readTypeBody (bytecodeistream & str);
+
     public:
     /** Thrown when it does not make sense to parse more bytecode.
      * Formerly we used to unset YCode::valid instead.
@@ -113,6 +128,13 @@ class Bytecode {
 	static std::ostream & writeValue (std::ostream & str, const YCPValue value);
 	static YCPValue readValue (bytecodeistream & str);
 
+	// value images (.target.ybin): a header with version, length and
+	// checksum, followed by one value in writeValue encoding. Values
+	// containing code or references cannot be written.
+	static bool writeValueImage (std::ostream & str, const YCPValue value);
+	// read the image of size bytes at data, YCPNull on error
+	static YCPValue readValueImage (const char * data, size_t size, const string & name);
+
 	// ycodelist_t * I/O
 	static std::ostream & writeYCodelist (std::ostream & str, const ycodelist_t *codelist);
 	static bool readYCodelist (bytecodeistream & str, ycodelist_t **anchor);
@@ -32,12 +32,12 @@ namespace YaST
 /// Function and source location, for backtraces
 struct CallFrame {
     YECallPtr function;
-    string filename;
+    const string* filename;	// interned, see ExecutionEnvironment::filenamePtr
     int linenumber;
     YCPValue* params;
 
-    CallFrame(const string& f, int l, YECallPtr func, YCPValue* p)
-	: function(func), filename(f), linenumber(l), params(p)
+    CallFrame()
+	: function(0), filename(0), linenumber(0), params(0)
     {
     }
 };
@@ -57,10 +57,16 @@ public:
     
 private:
     int m_linenumber;
-    string m_filename;
+    const string* m_filename;	// interned
     bool m_forced_filename;
     YStatementPtr m_statement;
     CallStack m_backtrace;
+    /**
+     * The frames pushed so far, m_backtrace points to the first
+     * m_backtrace.size() of them. They are reused, so pushing and
+     * popping frames does not allocate.
+     */
+    vector<CallFrame*> m_frames;
     /**
      * There is a limit of 1001 call frames (overridable by
      * Y2RECURSIONLIMIT in the environment). After that, a call is
@@ -70,7 +76,7 @@ private:
 
 public:
     ExecutionEnvironment ();
-    ~ExecutionEnvironment() {};
+    ~ExecutionEnvironment();
 
     /**
      * Get the current line number.
@@ -92,6 +98,18 @@ public:
      */
     void setFilename (const string & filename);
 
+    /**
+     * Get the current file name as a pointer that stays valid, for
+     * saving and restoring it around calls without copying the string.
+     * File names are interned, each one is stored only once.
+     */
+    const string* filenamePtr () const;
+
+    /**
+     * Restore a file name saved by filenamePtr.
+     */
+    void setFilenamePtr (const string* filename);
+
     /**
      * Return the currently evaluated statement.
      */
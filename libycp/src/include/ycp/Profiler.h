@@ -0,0 +1,174 @@
+/*---------------------------------------------------------------------\
+|								       |
+|		       __   __	  ____ _____ ____		       |
+|		       \ \ / /_ _/ ___|_   _|___ \		       |
+|			\ V / _` \___ \ | |   __) |		       |
+|			 | | (_| |___) || |  / __/		       |
+|			 |_|\__,_|____/ |_| |_____|		       |
+|								       |
+|				core system			       |
+|							 (C) SuSE GmbH |
+\----------------------------------------------------------------------/
+
+   File:	Profiler.h
+
+   Sampling profiler and call statistics for YCP code
+
+/-*/
+// -*- c++ -*-
+
+#ifndef Profiler_h
+#define Profiler_h
+
+#include <signal.h>
+#include <stdint.h>
+#include <string>
+
+using std::string;
+
+class SymbolEntry;
+struct declaration;
+
+namespace YaST
+{
+
+/**
+ * Counts the YCP call stacks seen on SIGPROF ticks and writes them
+ * as folded stacks, the input format of flamegraph tools.
+ *
+ * The signal handler only counts ticks, the stack is taken by the
+ * interpreter itself at the next checkpoint, where it is consistent.
+ * Checkpoints come before the interpreter moves on to another
+ * statement, call or return, so a tick is charged to the location it
+ * fell into. Each line of the output is
+ * <pre>caller;...;function;file:line count</pre>
+ * with the outermost caller first and the location of the statement
+ * being evaluated as the innermost frame.
+ *
+ * Set Y2PROFILE to the output file name in the environment to profile
+ * a whole run, or call start and stop.
+ */
+class Profiler
+{
+public:
+    enum { DEFAULT_FREQUENCY = 1000 };
+
+    /**
+     * Start sampling at frequency ticks per second of CPU time. The
+     * samples are written to output by stop, or at exit.
+     */
+    static bool start (const string& output, int frequency = DEFAULT_FREQUENCY);
+
+    /**
+     * Stop sampling and write the samples.
+     */
+    static void stop ();
+
+    /**
+     * Take a sample if a tick is pending. Cheap, called for every
+     * statement, call and return.
+     */
+    static void checkpoint ()
+    {
+	if (s_ticks)
+	    sample ();
+    }
+
+private:
+    static volatile sig_atomic_t s_ticks;
+
+    static void tick (int);
+    static void sample ();
+    static void atExit ();
+};
+
+
+class CallTimer;
+
+/**
+ * Exact call counts and times per YCP function and per builtin.
+ *
+ * YEFunction, YEFunctionPointer and YEBuiltin time their calls with a
+ * CallTimer when enabled. Inclusive time counts a recursive function
+ * once, exclusive time is the inclusive time minus the time spent in
+ * timed calls made from it. The report, sorted by exclusive time, is
+ * written at exit and whenever SIGRTMIN is received.
+ *
+ * Set Y2CALLSTATS to the report file name in the environment.
+ *
+ * Functions are counted by their SymbolEntry, named when first seen.
+ * A function whose entry is freed and whose address is reused by
+ * another one, e.g. of a module loaded later, adds to the stats of
+ * the first name. Keying by the qualified name would avoid that, at
+ * the cost of building the name on every call.
+ */
+class CallStats
+{
+public:
+    struct entry_t
+    {
+	string name;
+	unsigned long calls;
+	uint64_t inclusive;	// ns
+	uint64_t exclusive;	// ns
+	int active;		// recursion depth
+    };
+
+    static bool enabled () { return s_enabled; }
+
+    /**
+     * Start counting, the report is written to output.
+     */
+    static bool start (const string& output);
+
+    /**
+     * Write the report.
+     */
+    static void dump ();
+
+    static entry_t* function (const SymbolEntry* sentry);
+    static entry_t* builtin (const struct declaration* decl);
+
+private:
+    friend class CallTimer;
+
+    static bool s_enabled;
+    static volatile sig_atomic_t s_dump;
+    static CallTimer* s_current;
+
+    static void request (int);
+    static void atExit ();
+};
+
+
+/**
+ * Times one call, from start to destruction.
+ * <pre>
+ *   CallTimer timer;
+ *   if (CallStats::enabled ())
+ *	timer.start (CallStats::builtin (m_decl));
+ * </pre>
+ */
+class CallTimer
+{
+public:
+    CallTimer () : m_entry (0) {}
+    ~CallTimer () { if (m_entry) stop (); }
+
+    void start (CallStats::entry_t* entry);
+
+private:
+    CallTimer (const CallTimer&);
+    CallTimer& operator= (const CallTimer&);
+
+    void stop ();
+
+    CallStats::entry_t* m_entry;
+    CallTimer* m_parent;
+    uint64_t m_begin;
+    uint64_t m_children;
+};
+
+}
+
+#endif /* Profiler_h */
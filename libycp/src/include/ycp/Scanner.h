@@ -33,6 +33,8 @@
 
 #include "ycp/StaticDeclaration.h"
 #include <stdio.h>
+#include <sys/types.h>
+#include <map>
 #include <string>
 
 class TableEntry;
@@ -110,6 +112,53 @@ private:
      */
     int m_inputFd;
 
+    /**
+     * Unbuffered input from m_inputFd is read in chunks of this size
+     * into m_readAhead. See LexerInput.
+     */
+    static const int READ_AHEAD = 8192;
+
+    /**
+     * Input read from m_inputFd but not passed to flex yet, starting
+     * at m_readAheadPos.
+     */
+    string m_readAhead;
+    string::size_type m_readAheadPos;
+
+    /**
+     * States of frameStep.
+     */
+    enum frame_state_t { FRAME_CODE, FRAME_STRING, FRAME_STRING_ESCAPE,
+			 FRAME_SLASH, FRAME_LINE_COMMENT, FRAME_COMMENT,
+			 FRAME_COMMENT_STAR };
+
+    /**
+     * Bracket nesting and lexical state of the top-level value
+     * being read, see frameStep.
+     */
+    int m_frameDepth;
+    frame_state_t m_frameState;
+
+    /**
+     * Only blanks since the last newline, a # there starts a comment.
+     */
+    bool m_frameLineStart;
+
+    /**
+     * Input read ahead by scanners that were destroyed before they
+     * used it, by file descriptor. A new scanner on the same file
+     * continues with it. dev and ino identify the file since the
+     * descriptor may have been closed and reused meanwhile.
+     */
+    struct read_ahead_t
+    {
+	dev_t dev;
+	ino_t ino;
+	string data;
+    };
+
+    static std::map<int, read_ahead_t> s_pendingInput;
+
     /**
      * Holds the value being scanned lastly.
      */
@@ -240,10 +289,12 @@ public:
 
     /**
      * Overriden from @ref yyFlexLexer. The flex scanner uses this
-     * function to get the next input characters. Our implementation
-     * always returns just one character. Too much lookahead would result
-     * in blocking and deadlock in a protocol situation.
-     * FIXME: when reading from file read max_size characters
+     * function to get the next input characters. If buffering is off
+     * we are reading a protocol and must not hand flex input beyond the
+     * end of the current top-level value, or it would be lost with the
+     * scanner. Input is still read in large chunks, but only passed on
+     * up to the next point where a value can end (see frameStep), the
+     * rest is kept for the next call.
      * @param buf Buffer where the input is to be stored in
      * @param max_size size of this buffer
      * @return the number of new input character. 0 on EOF.
@@ -324,6 +375,24 @@ private:
      */
     char *extend_scanbuffer (int size);
 
+    /**
+     * Feeds one character of unbuffered input to the frame tracker.
+     * Returns true if a top-level value may end after c, i.e. if
+     * flex must not be given any more input before asking for it.
+     * Errs on the side of stopping too early.
+     */
+    bool frameStep (char c);
+
+    /**
+     * Reads unbuffered input from m_inputFd, see LexerInput.
+     */
+    int readFramedFd (char *buf, int maxnum);
+
+    /**
+     * Reads unbuffered input from m_inputFile, see LexerInput.
+     */
+    int readFramedFile (char *buf, int maxnum);
+
 public:
 
     virtual void error(string error);
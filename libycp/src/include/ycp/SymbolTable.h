@@ -66,6 +66,7 @@ class TableEntry
     TableEntry *m_outer;
 
     const char *m_key;			// search key, usually the symbol name
+    unsigned int m_hash;		// SymbolTable::hash of m_key, set by SymbolTable::enter
     SymbolEntryPtr m_entry;		// complete symbol data, cannot be const since category might change
     const Point *m_point;		// definition point (file, line)
 
@@ -103,13 +104,17 @@ class SymbolTable
 #endif
 {
 private:
-    // number of buckets in hash table
-    int m_prime;
+    // number of buckets in hash table, a power of two
+    int m_size;
 
-    // the hash function
-    int hash (const char *s);
+    // number of entries in the hash chains (i.e. distinct keys),
+    // the table grows when it exceeds 3/4 of m_size
+    int m_count;
 
-    // the hash table [0 ... prime-1]
+    // the hash function, its result is stored in each TableEntry
+    static unsigned int hash (const char *s);
+
+    // the hash table [0 ... m_size-1]
     // a bucket is a (doubly) linked list of TableEntries
     // (via m_prev/m_next) each having the same hash value
     // (standard hash table implementation)
@@ -121,6 +126,29 @@ private:
 
     TableEntry **m_table;
 
+    // When the table grows, the buckets of the previous, smaller
+    // table are moved over incrementally: the bucket a key hashes to
+    // before it is used, plus a few more with each enter/find/remove.
+    // Buckets before m_migrated are already empty.
+    TableEntry **m_oldTable;
+    int m_oldSize;
+    int m_migrated;
+
+    // double the number of buckets
+    void grow ();
+
+    // move the old bucket of hash value h and some more
+    void migrate (unsigned int h);
+
+    // move all entries of old bucket i into m_table
+    void migrateBucket (int i);
+
+    // move everything left, needed before walking all buckets
+    void finishMigration () const;
+
+    // remove entry from the scope chain it is in (not at the top of)
+    void unlinkOuter (TableEntry *entry, int h);
+
     // these are the actually used entries of this table
     // they are only stored if needed
     bool m_track_usage;
@@ -136,8 +164,8 @@ public:
     //---------------------------------------------------------------
     // Constructor/Destructor
 
-    // create SymbolTable with hashsize prime
-    SymbolTable (int prime);
+    // create SymbolTable with (at least) hashsize buckets, <= 0 for the default
+    SymbolTable (int hashsize);
     ~SymbolTable();
 
     //---------------------------------------------------------------
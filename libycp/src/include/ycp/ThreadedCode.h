@@ -0,0 +1,115 @@
+/*---------------------------------------------------------------------\
+|								       |
+|		       __   __	  ____ _____ ____		       |
+|		       \ \ / /_ _/ ___|_   _|___ \		       |
+|			\ V / _` \___ \ | |   __) |		       |
+|			 | | (_| |___) || |  / __/		       |
+|			 |_|\__,_|____/ |_| |_____|		       |
+|								       |
+|				core system			       |
+|							 (C) SuSE GmbH |
+\----------------------------------------------------------------------/
+
+   File:	ThreadedCode.h
+
+   Linear, direct threaded form of YCode expression trees
+
+/-*/
+// -*- c++ -*-
+
+#ifndef ThreadedCode_h
+#define ThreadedCode_h
+
+#include <vector>
+
+#include "ycp/YCode.h"
+#include "ycp/YCPValue.h"
+#include "ycp/StaticDeclaration.h"
+#include "y2/SymbolEntry.h"
+
+/**
+ * @short Linear form of an expression tree
+ *
+ * The arithmetic, logical and comparison expressions found in loops are
+ * trees of YEBinary, YEUnary, YECompare, YEVariable and constants.
+ * Evaluating them means a virtual evaluate() call and a YCPValue return
+ * per node. ThreadedCode lowers such a tree into a sequence of
+ * instructions working on a small value stack. The instructions are
+ * dispatched by computed goto and call the builtins directly through
+ * declaration_t::ptr.
+ *
+ * Any other node is kept as it is and evaluated by a single instruction,
+ * and all nil checks and error messages are those of the tree nodes, so
+ * the result is always the same as that of YCode::evaluate.
+ *
+ * Statements and whole YBlocks are not lowered, they still walk their
+ * statement lists and reach ThreadedCode through their expressions.
+ *
+ * This is optional: set Y2THREADED in the environment or call
+ * ThreadedCode::setEnabled. The expression nodes then compile themselves
+ * on their first evaluation.
+ */
+class ThreadedCode
+{
+public:
+    /**
+     * Lowers the tree rooted at code. Returns 0 if the root itself
+     * cannot be lowered.
+     */
+    static ThreadedCode *compile (YCode *code);
+
+    /**
+     * Runs the code, same as evaluate() of the tree it was made from.
+     */
+    YCPValue evaluate ();
+
+    /**
+     * Is lowering enabled?
+     */
+    static bool enabled ();
+    static void setEnabled (bool enable);
+
+private:
+    ThreadedCode ();
+
+    /**
+     * Deepest stack a program may use. Deeper subtrees are
+     * evaluated as a whole.
+     */
+    static const int MAX_DEPTH = 8;
+
+    enum opcode_t {
+	OP_CONST,	// push value
+	OP_VARIABLE,	// push value of entry, evaluate code if it has none
+	OP_EVALUATE,	// push code->evaluate ()
+	OP_UNARY,	// replace top with decl (top)
+	OP_CHECK,	// first argument of a binary: if nil, jump to arg
+	OP_BINARY,	// replace two topmost with decl (first, second)
+	OP_COMPARE,	// replace two topmost with their comparison arg
+	OP_END		// return top
+    };
+
+    struct instruction_t
+    {
+	instruction_t (opcode_t o);
+
+	const void *handler;	// where evaluate dispatches to, see link
+	opcode_t op;
+	YCPValue value;
+	SymbolEntryPtr entry;
+	YCodePtr code;		// evaluated node, or argument for error messages
+	declaration_t *decl;
+	int arg;
+    };
+
+    std::vector<instruction_t> m_code;
+    bool m_linked;
+
+    static int s_enabled;
+
+    static bool lowerable (YCode *code);
+    void emit (YCodePtr code, int depth);
+    void emitTree (YCode *code, int depth);
+};
+
+#endif // ThreadedCode_h
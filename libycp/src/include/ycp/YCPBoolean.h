@@ -66,6 +66,11 @@ public:
      */
     YCPOrder compare(const YCPBoolean &) const;
 
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
+
     /**
      * Gives the ASCII representation of this value, i.e.
      * "true" or "false".
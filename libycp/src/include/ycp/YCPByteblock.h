@@ -51,6 +51,15 @@ protected:
      */
     YCPByteblockRep(const unsigned char *bytes, long len);
 
+    /**
+     * Creates a new YCPByteblockRep object that takes over the buffer
+     * instead of copying it.
+     * @param bytes buffer allocated with new [], it is deleted by the
+     * destructor.
+     * @param length length of the byte block.
+     */
+    YCPByteblockRep(unsigned char *bytes, long len, bool adopt);
+
     /**
      * Creates a new YCPByteblockRep object from a stream.
      * See YCPByteblock (bytecodeistream &) implementation.
@@ -92,6 +101,11 @@ public:
      */
     YCPOrder compare(const YCPByteblock& s) const;
 
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
+
     /**
      * Returns YT_BYTEBLOCK. See @ref YCPValueRep#type.
      */
@@ -110,6 +124,7 @@ class YCPByteblock : public YCPValue
     DEF_COMMON(Byteblock, Value);
 public:
     YCPByteblock(const unsigned char *r, long l) : YCPValue(new YCPByteblockRep(r, l)) {}
+    YCPByteblock(unsigned char *r, long l, bool adopt) : YCPValue(new YCPByteblockRep(r, l, adopt)) {}
     YCPByteblock(bytecodeistream & str);
 };
 
@@ -23,6 +23,7 @@
 
 // MemUsage.h defines/undefines D_MEMUSAGE
 #include <y2util/MemUsage.h>
+#include <y2util/MemPool.h>
 
 // include only forward declarations of iostream
 #include <iosfwd>
@@ -261,6 +262,12 @@ protected:
     virtual ~YCPElementRep();
 
 public:
+    /**
+     * Reps are small and numerous, they come from the MemPool.
+     */
+    static void *operator new(size_t size) { return MemPool::allocate(size); }
+    static void operator delete(void *p, size_t size) { MemPool::release(p, size); }
+
     /**
      * Casts this element into a pointer of type YCPValueRep
      */
@@ -70,6 +70,11 @@ public:
      */
     YCPOrder compare(const YCPFloat &v) const;
 
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
+
     /**
      * Returns an ASCII representation of this value.
      * Note that this must alway contain either a decimal
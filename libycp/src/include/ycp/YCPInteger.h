@@ -64,6 +64,11 @@ public:
      */
     YCPOrder compare(const YCPInteger &v) const;
 
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
+
     /**
      * Gives the ASCII representation of this value, i.e.
      * "1" or "-17" or "327698"
@@ -92,8 +97,17 @@ public:
 class YCPInteger : public YCPValue
 {
     DEF_COMMON(Integer, Value);
+
+    /**
+     * Small integers are shared, they are created on first use and
+     * never freed. Loop counters, indices and sizes are mostly small.
+     */
+    enum { SMALL_MIN = -128, SMALL_MAX = 1023 };
+    static YCPInteger* smallintegers[SMALL_MAX - SMALL_MIN + 1];
+    static const YCPIntegerRep* smallInteger(long long v);
+
 public:
-    YCPInteger(long long v) : YCPValue(new YCPIntegerRep(v)) {}
+    YCPInteger(long long v) : YCPValue(v >= SMALL_MIN && v <= SMALL_MAX ? smallInteger(v) : new YCPIntegerRep(v)) {}
     YCPInteger(const char *r, bool *valid = NULL) : YCPValue(new YCPIntegerRep(r, valid)) {}
     YCPInteger(bytecodeistream & str);
 };
@@ -197,6 +197,11 @@ public:
      */
     YCPOrder compare(const YCPList &v) const;
 
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
+
     /**
      * Returns an ASCII representation of the list.
      * Lists are denoted by comma separated values enclosed
@@ -257,6 +262,7 @@ public:
     void reverse() { ELEMENT->reverse(); }
     void swap(int x, int y) { ELEMENT->swap (x, y); }
     bool contains (const YCPValue& value) const { return CONST_ELEMENT->contains (value); }
+    size_t hash() const { return CONST_ELEMENT->hash (); }
     void sortlist() { ELEMENT->sortlist (); }
     void lsortlist() { ELEMENT->lsortlist (); }
     void fsortlist(const YCPCodeCompare& cmp) { ELEMENT->fsortlist (cmp); }
@@ -31,6 +31,7 @@
 // 2009-01-07. http://lists.opensuse.org/yast-devel/2009-01/msg00016.html
 typedef map<YCPValue, YCPValue, ycp_less> YCPValueYCPValueMap;
 struct YCPMapIterator;
+class YCPMapIndex;
  
 
 /**
@@ -48,6 +49,25 @@ private:
 
     YCPValueYCPValueMap stl_map;
 
+    /**
+     * Hash index of the string keys. Built by find once a map of at
+     * least INDEX_THRESHOLD entries was searched INDEX_THRESHOLD
+     * times, kept up to date by add and remove afterwards.
+     */
+    mutable YCPMapIndex *string_index;
+    mutable unsigned lookups;
+
+    enum { INDEX_THRESHOLD = 16 };
+
+    YCPValueYCPValueMap::const_iterator find(const YCPValue& key) const;
+
+    /**
+     * Not implemented, a copy would share and delete string_index
+     * twice and its iterators point into the other map.
+     */
+    YCPMapRep(const YCPMapRep&);
+    YCPMapRep& operator=(const YCPMapRep&);
+
 protected:
 
     typedef YCPValueYCPValueMap::iterator iterator;
@@ -66,7 +86,7 @@ protected:
     /**
      * Cleans up
      */
-    ~YCPMapRep() {}
+    ~YCPMapRep();
 
 public:
 
@@ -139,6 +159,11 @@ public:
      *         YO_GREATER, if this is greater to v
      */
     YCPOrder compare(const YCPMap &v) const;
+
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
         
     /**
      * Returns an ASCII representation of the map.
@@ -202,6 +227,7 @@ public:
     bool isEmpty() const { return CONST_ELEMENT->isEmpty(); }
     long size() const { return CONST_ELEMENT-> size (); }
     bool hasKey(const YCPValue& key) const { return CONST_ELEMENT->hasKey(key); }
+    size_t hash() const { return CONST_ELEMENT->hash(); }
     YCPValue value(const YCPValue& key) const { return CONST_ELEMENT-> value (key); }
     YCPMapIterator begin() const { return CONST_ELEMENT-> begin (); }
     YCPMapIterator end() const { return CONST_ELEMENT-> end (); }
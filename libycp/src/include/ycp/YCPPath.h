@@ -146,6 +146,11 @@ public:
      */
     YCPOrder compare(const YCPPath &v) const;
 
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
+
     /**
      * Returns a string representation of this object, that may
      * be parsed by the YCP parser. A path is denoted by a
@@ -24,6 +24,7 @@
 
 #include "YCPValue.h"
 #include <y2util/Ustring.h>
+#include <utility>
 
    
 /**
@@ -41,6 +42,21 @@ class YCPStringRep : public YCPValueRep
 
     string v;
     bool is_ascii;
+    mutable size_t hash_value;	// 0: not computed yet
+
+    /**
+     * Number of characters of a non ASCII string, -1 if it is not
+     * valid UTF-8, -2 if not computed yet.
+     */
+    mutable long char_count;
+
+    /**
+     * Byte offsets of every CHAR_STEP-th character of a long non ASCII
+     * string, built by offset() on first use.
+     */
+    mutable vector<string::size_type> *char_offsets;
+
+    enum { CHAR_STEP = 32 };
 
 protected:
 
@@ -55,6 +71,13 @@ protected:
      */
     YCPStringRep(const string& s);
 
+    /**
+     * Creates a new YCPStringRep from a C++ string, taking over its
+     * contents without copying them. Used for large strings like
+     * whole files read by agents. The string must be UTF-8 encoded.
+     */
+    YCPStringRep(string&& s);
+
     /**
      * Creates a new YCPStringRep from a C++ wstring.
      * @param s A wstring that is taken literally as value of the newly create
@@ -64,6 +87,19 @@ protected:
      */
     YCPStringRep(const wstring& s);
 
+    ~YCPStringRep();
+
+    /**
+     * Appends s in place. Only for a value that is not shared, see
+     * YCPString::append.
+     */
+    void append(const string& s);
+
+    /**
+     * Returns a copy for YCPString::append to change.
+     */
+    const YCPElementRep* shallowCopy() const;
+
 public:
 
     /**
@@ -101,6 +137,30 @@ public:
      */
     const char *value_cstr() const;
 
+    /**
+     * Returns the number of characters (not bytes) of the string, or -1
+     * if it is not valid UTF-8. Computed once, without converting the
+     * string.
+     */
+    long length() const;
+
+    /**
+     * Returns the byte offset of the character at index, which must be
+     * between 0 and length(). length() must not be -1.
+     */
+    string::size_type offset(long index) const;
+
+    /**
+     * Returns the number of characters before the byte offset, which
+     * must be at a character boundary. length() must not be -1.
+     */
+    long index(string::size_type offset) const;
+
+    /**
+     * Returns a hash of the value, computed once.
+     */
+    virtual size_t hash() const;
+
     /**
      * Returns a string representation of the value of this
      * object. It contains enclosing quotes. Newlines and
@@ -133,12 +193,35 @@ public:
 class YCPString : public YCPValue
 {
     DEF_COMMON(String, Value);
+
+    static YCPString* emptystring;
+    static const YCPStringRep* emptyString();
+
 public:
-    YCPString(const string& s) : YCPValue(new YCPStringRep(s)) {}
+    YCPString(const string& s) : YCPValue(s.empty() ? emptyString() : new YCPStringRep(s)) {}
+    YCPString(string&& s) : YCPValue(s.empty() ? emptyString() : new YCPStringRep(std::move(s))) {}
     YCPString(const wstring& s) : YCPValue(new YCPStringRep(s)) {}
     YCPString(bytecodeistream & str);
 
     bool isEmpty() const { return CONST_ELEMENT->isEmpty(); }
+
+    /**
+     * Appends s to the value. The value is changed in place if this is
+     * its only reference, otherwise it is copied first. Building a
+     * string by repeated appends is linear then.
+     */
+    void append(const string& s);
+
+    /**
+     * Returns a shared YCPString for s. Meant for short strings that
+     * occur over and over again, like map keys: all of them refer to
+     * the same YCPStringRep then. Strings longer than
+     * INTERN_MAX_LENGTH, and any string once the table holds
+     * INTERN_MAX_COUNT entries, are not shared.
+     */
+    static YCPString intern(const string& s);
+
+    enum { INTERN_MAX_LENGTH = 32, INTERN_MAX_COUNT = 4096 };
 };
 
 #undef CONST_ELEMENT
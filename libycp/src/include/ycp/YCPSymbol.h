@@ -75,6 +75,11 @@ public:
      */
     YCPOrder compare(const YCPSymbol &v) const;
 
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
+
     /**
      * Returns the ASCII representation of the symbol.
      */
@@ -100,6 +100,11 @@ public:
      * 
      */
     YCPOrder compare(const YCPTerm &v) const;
+
+    /**
+     * Returns a hash of the value, equal values have equal hashes.
+     */
+    virtual size_t hash() const;
     
     /**
      * Creates a copy of this term, i.e. creates a new term with
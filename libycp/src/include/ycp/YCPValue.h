@@ -262,6 +262,13 @@ public:
      */
     YCPOrder compare(const YCPValue &v, bool rl = false) const;
 
+    /**
+     * Returns a hash of the value, consistent with equal: equal values
+     * have equal hashes. The default is the value type, reps that can
+     * be equal to each other override it.
+     */
+    virtual size_t hash() const;
+
     virtual std::ostream & toXml (std::ostream & str, int indent ) const = 0;
 };
 
@@ -281,6 +288,13 @@ public:
      * initialize the value to YCPNull ().
      */
     YCPValue ();
+
+    /**
+     * Whether small integers, the empty string and interned strings
+     * share one representation. Setting Y2NOSHARING in the
+     * environment turns that off, to count what the sharing saves.
+     */
+    static bool sharing ();
 };
 
 
@@ -41,6 +41,7 @@ using std::string;
 
 // MemUsage.h defines/undefines D_MEMUSAGE
 #include <y2util/MemUsage.h>
+#include <y2util/MemPool.h>
 #include "ycp/YCodePtr.h"
 
 #include "ycp/YCPValue.h"
@@ -87,6 +88,13 @@ private:
     REP_BODY(YCode);
 
 public:
+    /**
+     * Nodes are allocated from the MemPool, parsing a module
+     * creates lots of them.
+     */
+    static void *operator new (size_t size) { return MemPool::allocate (size); }
+    static void operator delete (void *p, size_t size) { MemPool::release (p, size); }
+
     enum ykind {
 	yxError = 0,
 	// [1] Constants	(-> YCPValue, except(!) term -> yeLocale)
@@ -343,6 +351,14 @@ public:
     static void ensureBindDomain (const string& domain);
     static void bindDomainDir (const string& domain, const string& domain_path);
     static bool findDomain(const string& domain);
+
+    /**
+     * Changes whenever translations may have changed: gettext counts
+     * loaded catalogs, textdomain and locale changes in
+     * _nl_msg_cat_cntr, and WFM::SetLanguage increases it too.
+     */
+    static int catalogGeneration ();
+
     YLocale (const char *locale, const char *textdomain);
     YLocale (bytecodeistream & str);
     ~YLocale ();
@@ -359,6 +375,10 @@ private:
 
     t_uniquedomains::const_iterator m_domain;
 
+    // the last translation and the catalogGeneration it is valid for
+    YCPValue m_translation;
+    int m_generation;
+
 };
 
 /**
@@ -34,6 +34,8 @@ class Logger;
 
 //---------------------------------------------------------
 
+class ThreadedCode;
+
 DEFINE_DERIVED_POINTER(YEVariable, YCode);
 DEFINE_DERIVED_POINTER(YEReference, YCode);
 DEFINE_DERIVED_POINTER(YETerm, YCode);
@@ -139,6 +141,8 @@ private:
     YCodePtr m_left;
     c_op m_op;
     YCodePtr m_right;
+    ThreadedCode *m_threaded;
+    friend class ThreadedCode;
 public:
     YECompare (YCodePtr left, c_op op, YCodePtr right);
     YECompare (bytecodeistream & str);
@@ -146,6 +150,8 @@ public:
     virtual ykind kind () const { return yeCompare; }
     string toString () const;
     YCPValue evaluate (bool cse = false);
+    // compare evaluated operands
+    static YCPValue compare (const YCPValue & vl, c_op op, const YCPValue & vr);
     std::ostream & toStream (std::ostream & str) const;
     std::ostream & toXml (std::ostream & str, int indent ) const;
     constTypePtr type() const { return Type::Boolean; }
@@ -162,6 +168,10 @@ class YELocale : public YCode
     const char *m_plural;
     YCodePtr m_count;
     YLocale::t_uniquedomains::const_iterator m_domain;
+    // the last translation, for which count and YLocale::catalogGeneration
+    YCPValue m_translation;
+    long long m_translated_count;
+    int m_generation;
 public:
     YELocale (const char *singular, const char *plural, YCodePtr count, const char *textdomain);
     YELocale (bytecodeistream & str);
@@ -254,6 +264,8 @@ class YEUnary : public YCode
     REP_BODY(YEUnary);
     declaration_t *m_decl;
     YCodePtr m_arg;		// argument
+    ThreadedCode *m_threaded;
+    friend class ThreadedCode;
 public:
     YEUnary (declaration_t *decl, YCodePtr arg);		// expression
     YEUnary (bytecodeistream & str);
@@ -278,12 +290,30 @@ class YEBinary : public YCode
     declaration_t *m_decl;
     YCodePtr m_arg1;		// argument1
     YCodePtr m_arg2;		// argument2
+    ThreadedCode *m_threaded;
+    friend class ThreadedCode;
 public:
     YEBinary (declaration_t *decl, YCodePtr arg1, YCodePtr arg2);
     YEBinary (bytecodeistream & str);
     ~YEBinary ();
     virtual ykind kind () const { return yeBinary; }
     declaration_t *decl ();
+
+    enum { MAX_APPEND = 8 };
+
+    /**
+     * If code is a chain of at most MAX_APPEND string additions to
+     * the variable entry, like <tt>s + a + b</tt>, return its outermost
+     * node, else 0. Used by YSAssign for <tt>s = s + a + b</tt>.
+     */
+    static YEBinary *stringAppend (YCodePtr code, SymbolEntryPtr entry);
+
+    /**
+     * Evaluate a chain found by stringAppend as the right hand side of
+     * an assignment to entry. The value of the variable is appended to
+     * in place when nothing else refers to it.
+     */
+    YCPValue evaluateAppend (SymbolEntryPtr entry);
 //    YCodePtr arg1 () const;
 //    YCodePtr arg2 () const;
     string toString () const;
@@ -479,6 +509,8 @@ public:
 class YEFunction : public YECall
 {
     REP_BODY(YEFunction);
+    // up to this many evaluated parameters are kept on the stack
+    enum { LOCAL_PARAMS = 8 };
 public:
     YEFunction (TableEntry* entry);
     YEFunction (bytecodeistream & str);
@@ -32,6 +32,7 @@ using std::string;
 #include "ycp/ycpless.h"
 
 class YBlock;		// forward declaration for YDo, YRepeat
+class YEBinary;		// forward declaration for YSAssign
 
 //-------------------------------------------------------------------
 
@@ -254,6 +255,7 @@ class YSAssign : public YStatement
 protected:
     SymbolEntryPtr m_entry;
     YCodePtr m_code;
+    YEBinary *m_append;		// m_code if it is <m_entry> + ..., see YEBinary::stringAppend
 public:
     YSAssign (SymbolEntryPtr entry, YCodePtr code, int line = 0);
     YSAssign (bytecodeistream & str);
@@ -27,14 +27,68 @@
 #include <stdio.h>
 #include <fcntl.h>
 
+#include <time.h>
+
 #include <string>
 #include <list>
+#include <map>
 #include <vector>
+#include <unordered_set>
 
 using std::string;
 using std::vector;
 
 
+/**
+ * The names of the entries of one directory. The directory is listed
+ * once and listed again when its modification time changes, so asking
+ * whether a file exists is a hash lookup instead of a syscall. To keep
+ * that cheap the directory itself is checked at most once a second.
+ */
+class Y2DirSnapshot
+{
+public:
+    Y2DirSnapshot (const string& dir);
+
+    /**
+     * Does the directory contain an entry called name?
+     */
+    bool contains (const string& name);
+
+    /**
+     * Rereads the directory if it has changed since it was last listed.
+     */
+    void refresh ();
+
+    /**
+     * Makes the next lookup check the directory for changes, even if
+     * it was checked less than a second ago.
+     */
+    void expire () { m_checked = 0; }
+
+    const string& directory () const { return m_dir; }
+
+    /**
+     * Increased each time any snapshot sees a directory change. Caches
+     * of lookup results can use it to find out that they are stale.
+     */
+    static unsigned long generation () { return s_generation; }
+
+private:
+    void list ();
+
+    string m_dir;
+    bool m_exists;
+    time_t m_mtime;
+    long m_mtime_nsec;
+    time_t m_checked;
+    std::unordered_set<string> m_names;
+
+    static unsigned long s_generation;
+};
+
+
+
 class Y2PathSearch
 {
 
@@ -99,6 +153,23 @@ public:
      */
     static string completeFilename (const string& fname);
 
+    /**
+     * Returns the snapshot of the directory dir, creating it on first use.
+     */
+    static Y2DirSnapshot& snapshot (const string& dir);
+
+    /**
+     * Checks all snapshots for changes and returns the current
+     * Y2DirSnapshot::generation.
+     */
+    static unsigned long snapshotGeneration ();
+
+    /**
+     * Expires all snapshots. Call it after creating files that may be
+     * looked up in the same second.
+     */
+    static void expireSnapshots ();
+
 protected:
     static bool searchPrefixWarn;
 
@@ -109,6 +180,8 @@ private:
 
     static vector<string> paths;
     static void initializePaths();
+
+    static std::map<string, Y2DirSnapshot*> snapshots;
 };
 
 /**
@@ -181,8 +254,17 @@ public:
      */
     static string bytecodeForFile (string file);
 
+    /**
+     * Switches the snapshot mode of find: each search directory is listed
+     * once (see Y2DirSnapshot) and names that are not in the listing are
+     * skipped without touching the filesystem. Also enabled by setting
+     * Y2SNAPSHOTSEARCH in the environment.
+     */
+    static void setSnapshots (bool enable);
+
 private:
     static bool initialized;
+    static bool use_snapshots;
     static std::list<string> searchList[num_Kind];
     static void initialize (Kind kind, const char *suffix);
 };
@@ -59,6 +59,36 @@ utf82wchar (const std::string& in, std::wstring* out);
 bool
 wchar2utf8 (const std::wstring& in, std::string* out);
 
+
+/**
+ *  Count the characters of a UTF-8 encoded string without converting
+ *  it. Return -1 if the string is not valid UTF-8 (illegal, truncated
+ *  or overlong sequences, surrogates, values above U+10FFFF); such
+ *  strings have to go through utf82wchar to get its replacement of
+ *  illegal sequences.
+ */
+long
+utf8length (const std::string& in);
+
+
+/**
+ *  Decode the character starting at byte *pos of a valid UTF-8 string
+ *  and advance *pos to the next one.
+ */
+inline wchar_t
+utf8next (const std::string& in, std::string::size_type* pos)
+{
+    unsigned char c = in[(*pos)++];
+    if (c < 0x80)
+	return c;
+
+    int follow = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : 1;
+    wchar_t ret = c & (0x3f >> follow);
+    while (follow-- > 0)
+	ret = (ret << 6) | (in[(*pos)++] & 0x3f);
+    return ret;
+}
+
 }
 
 #endif
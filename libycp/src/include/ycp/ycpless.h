@@ -101,4 +101,22 @@ private:
 };
 
 
+/*
+ * Global hash functor for unordered STL-containers, to be used together
+ * with ycp_equal_to. Equal values have equal hashes, see
+ * YCPValueRep::hash.
+ */
+class ycp_hash : public std::unary_function<YCPValue, size_t>
+{
+
+public:
+
+    size_t operator()(const YCPValue& x) const
+    {
+	return x->hash();
+    }
+
+};
+
+
 #endif   // ycpless_h
@@ -28,6 +28,7 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <unistd.h>
+#include <dirent.h>
 #include <boost/algorithm/string.hpp>
 
 #include <ycp/y2log.h>
@@ -38,6 +39,107 @@
 bool Y2PathSearch::searchPrefixWarn = true;
 
 
+unsigned long Y2DirSnapshot::s_generation = 0;
+
+
+Y2DirSnapshot::Y2DirSnapshot (const string& dir)
+    : m_dir (dir)
+    , m_exists (false)
+    , m_mtime (0)
+    , m_mtime_nsec (0)
+    , m_checked (0)
+{
+    list ();
+}
+
+
+void
+Y2DirSnapshot::list ()
+{
+    m_names.clear ();
+    m_exists = false;
+    m_checked = time (NULL);
+
+    struct stat st;
+    if (stat (m_dir.c_str (), &st) != 0 || !S_ISDIR (st.st_mode))
+	return;
+
+    DIR *dir = opendir (m_dir.c_str ());
+    if (!dir)
+	return;
+
+    struct dirent *entry;
+    while ((entry = readdir (dir)) != NULL)
+	m_names.insert (entry->d_name);
+    closedir (dir);
+
+    m_exists = true;
+    m_mtime = st.st_mtime;
+    m_mtime_nsec = st.st_mtim.tv_nsec;
+
+    y2debug ("Listed %s: %zu entries", m_dir.c_str (), m_names.size ());
+}
+
+
+void
+Y2DirSnapshot::refresh ()
+{
+    time_t now = time (NULL);
+    if (now == m_checked)
+	return;
+    m_checked = now;
+
+    struct stat st;
+    bool exists = stat (m_dir.c_str (), &st) == 0 && S_ISDIR (st.st_mode);
+    if (exists == m_exists
+	&& (!exists || (st.st_mtime == m_mtime && st.st_mtim.tv_nsec == m_mtime_nsec)))
+	return;
+
+    list ();
+    ++s_generation;
+}
+
+
+bool
+Y2DirSnapshot::contains (const string& name)
+{
+    refresh ();
+    return m_names.find (name) != m_names.end ();
+}
+
+
+std::map<string, Y2DirSnapshot*> Y2PathSearch::snapshots;
+
+
+Y2DirSnapshot&
+Y2PathSearch::snapshot (const string& dir)
+{
+    std::map<string, Y2DirSnapshot*>::iterator it = snapshots.find (dir);
+    if (it == snapshots.end ())
+	it = snapshots.insert (std::make_pair (dir, new Y2DirSnapshot (dir))).first;
+    return *it->second;
+}
+
+
+unsigned long
+Y2PathSearch::snapshotGeneration ()
+{
+    for (std::map<string, Y2DirSnapshot*>::iterator it = snapshots.begin ();
+	 it != snapshots.end (); ++it)
+	it->second->refresh ();
+    return Y2DirSnapshot::generation ();
+}
+
+
+void
+Y2PathSearch::expireSnapshots ()
+{
+    for (std::map<string, Y2DirSnapshot*>::iterator it = snapshots.begin ();
+	 it != snapshots.end (); ++it)
+	it->second->expire ();
+}
+
+
 vector<string>
 Y2PathSearch::getPaths()
 {
@@ -206,7 +308,13 @@ string
 Y2PathSearch::findy2plugin (string name, int level)
 {
     // All plugins must follow this naming convention.
-    string filename = searchPath (PLUGIN, level) + "/libpy2" + name + ".so.2";
+    string dir = searchPath (PLUGIN, level);
+    string basename = "libpy2" + name + ".so.2";
+
+    if (!snapshot (dir).contains (basename))
+	return "";
+
+    string filename = dir + "/" + basename;
 
     y2debug ("Testing existence of plugin %s", filename.c_str ());
 
@@ -259,6 +367,8 @@ std::list<string> YCPPathSearch::searchList[YCPPathSearch::num_Kind];
 
 bool YCPPathSearch::initialized = false;
 
+bool YCPPathSearch::use_snapshots = false;
+
 
 void
 YCPPathSearch::initialize (Kind kind, const char *suffix)
@@ -279,6 +389,8 @@ YCPPathSearch::initialize ()
 	initialize (Client, "/clients");
 	initialize (Include, "/include");
 	initialize (Module, "/modules");
+	if (getenv ("Y2SNAPSHOTSEARCH"))
+	    use_snapshots = true;
 	initialized = true;
     }
 }
@@ -299,10 +411,32 @@ YCPPathSearch::find (Kind kind, const string& name)
 
     initialize ();
 
+    // in snapshot mode split the name into the directory to look into
+    // (relative to the search path) and the entry to look for
+    string subdir, basename;
+    if (use_snapshots)
+    {
+	string slashes = boost::replace_all_copy (name, "::", "/");
+	string::size_type slash = slashes.rfind ('/');
+	if (slash == string::npos)
+	    basename = slashes;
+	else
+	{
+	    subdir = "/" + slashes.substr (0, slash);
+	    basename = slashes.substr (slash + 1);
+	}
+    }
+
     std::list<string>& kindList = searchList[kind];
     std::list<string>::iterator i = kindList.begin (), e = kindList.end ();
     while (i != e)
     {
+	if (use_snapshots && !snapshot (*i + subdir).contains (basename))
+	{
+	    ++i;
+	    continue;
+	}
+
 	string pathname = completeFilename (*i + '/' + name);
 	y2debug ("trying %s", pathname.c_str ());
 	if (access (pathname.c_str(), R_OK) == 0)
@@ -340,6 +474,13 @@ YCPPathSearch::findModule (string name, bool the_source)
 }
 
 
+void
+YCPPathSearch::setSnapshots (bool enable)
+{
+    use_snapshots = enable;
+}
+
+
 void
 YCPPathSearch::addPath (Kind kind, const string& path)
 {
@@ -6,6 +6,7 @@
 
 
 #include <errno.h>
+#include <string.h>
 
 #include "y2log.h"
 #include "y2string.h"
@@ -163,4 +164,73 @@ wchar2utf8 (const std::wstring& in, std::string* out)
     return recode (cd, in, out);
 }
 
+
+
+long
+utf8length (const std::string& in)
+{
+    const unsigned char* p = (const unsigned char*)(in.data ());
+    const unsigned char* end = p + in.size ();
+
+    long count = 0;
+
+    while (p < end)
+    {
+	// skip plain ASCII a word at a time
+	while (end - p >= (long)(sizeof (unsigned long)))
+	{
+	    unsigned long word;
+	    memcpy (&word, p, sizeof (word));
+	    if (word & (~0UL / 0xff * 0x80))
+		break;
+	    p += sizeof (word);
+	    count += sizeof (word);
+	}
+	if (p == end)
+	    break;
+
+	unsigned char c = *p++;
+	count++;
+	if (c < 0x80)
+	    continue;
+
+	int follow;
+	unsigned long min;
+	if (c >= 0xc2 && c <= 0xdf)
+	{
+	    follow = 1;
+	    min = 0x80;
+	}
+	else if (c >= 0xe0 && c <= 0xef)
+	{
+	    follow = 2;
+	    min = 0x800;
+	}
+	else if (c >= 0xf0 && c <= 0xf4)
+	{
+	    follow = 3;
+	    min = 0x10000;
+	}
+	else
+	    return -1;
+
+	if (end - p < follow)
+	    return -1;
+
+	unsigned long value = c & (0x3f >> follow);
+	for (int i = 0; i < follow; i++)
+	{
+	    if ((p[i] & 0xc0) != 0x80)
+		return -1;
+	    value = (value << 6) | (p[i] & 0x3f);
+	}
+	p += follow;
+
+	if (value < min || value > 0x10ffff || (value >= 0xd800 && value <= 0xdfff))
+	    return -1;
+    }
+
+    return count;
+}
+
 }
@@ -0,0 +1,51 @@
+#!/bin/bash
+#
+# bench.sh - time YCP scripts with runycp
+#
+# usage: bench.sh [-n runs] [-e VAR=value]... script.ycp...
+#
+# Runs each script with the default settings and once more for each
+# -e setting, and prints the best wall clock time of the runs and its
+# ratio to the default. Run it from libycp/testsuite, where make check
+# builds runycp, e.g.
+#
+#   benchmark/bench.sh -e Y2THREADED=1 benchmark/loops.ycp
+#
+
+runs=5
+variants=("")
+
+while getopts "n:e:" opt; do
+    case $opt in
+	n) runs=$OPTARG ;;
+	e) variants+=("$OPTARG") ;;
+	*) echo "usage: $0 [-n runs] [-e VAR=value]... script.ycp..." >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+unset Y2DEBUG Y2DEBUGALL Y2DEBUGGER
+export Y2SILENTSEARCH=1
+export LC_ALL=C
+TIMEFORMAT=%R
+
+best_time ()
+{
+    local best=
+    for ((i = 0; i < runs; i++)); do
+	local t=$( { time env $1 ./runycp -l /dev/null -I tests/Include -M tests/Module "$2" >/dev/null 2>&1 ; } 2>&1 )
+	best=$(awk -v a="$best" -v b="$t" 'BEGIN { print (a == "" || b < a) ? b : a }')
+    done
+    echo $best
+}
+
+printf "%-20s %-24s %9s %7s\n" script settings seconds ratio
+for script in "$@"; do
+    base=
+    for v in "${variants[@]}"; do
+	t=$(best_time "$v" "$script")
+	[ -z "$base" ] && base=$t
+	printf "%-20s %-24s %9.3f %7.2f\n" "$(basename $script)" "${v:-default}" $t \
+	    $(awk -v a="$t" -v b="$base" 'BEGIN { print a / b }')
+    done
+done
@@ -0,0 +1,64 @@
+#!/bin/bash
+#
+# startup.sh - compare the startup time of ycpc builds
+#
+# usage: startup.sh [-n runs] [-c count] ycpc...
+#
+# Compiles an empty client with each given ycpc and runs it count
+# times (default 100) with ycpc -r. Nearly all of the time goes to
+# loading the libraries and registering the builtin declarations.
+# Prints the best of the runs per start and its ratio to the first
+# ycpc, e.g. before and after a change to StaticDeclaration:
+#
+#   benchmark/startup.sh /usr/bin/ycpc ../../base/tools/ycpc/ycpc
+#
+
+runs=5
+count=100
+
+while getopts "n:c:" opt; do
+    case $opt in
+	n) runs=$OPTARG ;;
+	c) count=$OPTARG ;;
+	*) echo "usage: $0 [-n runs] [-c count] ycpc..." >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 [-n runs] [-c count] ycpc..." >&2
+    exit 1
+fi
+
+unset Y2DEBUG Y2DEBUGALL Y2DEBUGGER
+export Y2SILENTSEARCH=1
+export LC_ALL=C
+TIMEFORMAT=%R
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+printf "%-32s %12s %7s\n" ycpc "ms per start" ratio
+base=
+for ycpc in "$@"; do
+    dir=$tmp/$(basename $ycpc).$RANDOM
+    mkdir $dir
+    echo "{ return nil; }" > $dir/empty.ycp
+    if ! $ycpc -c -q -l /dev/null $dir/empty.ycp >/dev/null; then
+	echo "$ycpc: compilation failed" >&2
+	exit 1
+    fi
+
+    best=
+    for ((i = 0; i < runs; i++)); do
+	t=$( { time for ((j = 0; j < count; j++)); do
+		   $ycpc -r -q -l /dev/null $dir/empty.ybc >/dev/null 2>&1
+	       done ; } 2>&1 )
+	best=$(awk -v a="$best" -v b="$t" 'BEGIN { print (a == "" || b < a) ? b : a }')
+    done
+
+    ms=$(awk -v t="$best" -v n="$count" 'BEGIN { print t * 1000 / n }')
+    [ -z "$base" ] && base=$ms
+    printf "%-32s %12.2f %7.2f\n" $ycpc $ms \
+	$(awk -v a="$ms" -v b="$base" 'BEGIN { print a / b }')
+done
@@ -0,0 +1,70 @@
+#!/bin/bash
+#
+# ybc-size.sh - compare .ybc size and load time of ycpc builds
+#
+# usage: ybc-size.sh [-n runs] [-I includedir] moduledir ycpc...
+#
+# Compiles every module below moduledir with each given ycpc, in a
+# copy of the directory, and prints the total size of the .ybc files,
+# the best wall clock time of reading all of them back with ycpc -p
+# and both ratios to the first ycpc. Compare an old build with a new
+# one over the installed module set, e.g.
+#
+#   benchmark/ybc-size.sh -I /usr/share/YaST2/include \
+#	/usr/share/YaST2/modules /usr/bin/ycpc ../../base/tools/ycpc/ycpc
+#
+
+runs=5
+incdirs=()
+
+while getopts "n:I:" opt; do
+    case $opt in
+	n) runs=$OPTARG ;;
+	I) incdirs+=(-I "$OPTARG") ;;
+	*) echo "usage: $0 [-n runs] [-I includedir] moduledir ycpc..." >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 [-n runs] [-I includedir] moduledir ycpc..." >&2
+    exit 1
+fi
+
+moddir=$1
+shift
+
+unset Y2DEBUG Y2DEBUGALL Y2DEBUGGER
+export Y2SILENTSEARCH=1
+export LC_ALL=C
+TIMEFORMAT=%R
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+printf "%-32s %6s %10s %7s %9s %7s\n" ycpc files bytes ratio seconds ratio
+base_size=
+base_time=
+for ycpc in "$@"; do
+    dir=$tmp/$(basename $ycpc).$RANDOM
+    mkdir $dir
+    cp "$moddir"/*.ycp $dir
+    # -f compiles the modules in the order of their imports
+    if ! $ycpc -f -c -q -l /dev/null -M $dir "${incdirs[@]}" $dir >/dev/null; then
+	echo "$ycpc: compilation failed" >&2
+	exit 1
+    fi
+    files=$(ls $dir/*.ybc | wc -l)
+    size=$(cat $dir/*.ybc | wc -c)
+
+    best=
+    for ((i = 0; i < runs; i++)); do
+	t=$( { time $ycpc -p -q -l /dev/null -M $dir "${incdirs[@]}" $dir/*.ybc >/dev/null 2>&1 ; } 2>&1 )
+	best=$(awk -v a="$best" -v b="$t" 'BEGIN { print (a == "" || b < a) ? b : a }')
+    done
+
+    [ -z "$base_size" ] && base_size=$size && base_time=$best
+    printf "%-32s %6d %10d %7.2f %9.3f %7.2f\n" $ycpc $files $size \
+	$(awk -v a="$size" -v b="$base_size" 'BEGIN { print a / b }') $best \
+	$(awk -v a="$best" -v b="$base_time" 'BEGIN { print a / b }')
+done
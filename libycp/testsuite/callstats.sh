@@ -0,0 +1,53 @@
+#!/bin/bash
+#
+# callstats.sh - check the Y2CALLSTATS report of runycp
+#
+# Counts the calls of a recursive function, of a function called by
+# a pointer and of two overloads of a builtin. The recursive function
+# sleeps 100 ms on each of its three levels, its inclusive time counts
+# the 300 ms once and its exclusive time leaves them to sleep.
+#
+
+unset Y2DEBUG Y2DEBUGALL Y2DEBUGGER
+export Y2SILENTSEARCH=1
+
+report=tmp.callstats
+rm -f $report
+
+Y2CALLSTATS=$report ./runycp -l /dev/null ${srcdir:-.}/tests/callstats/callstats.ycp >/dev/null 2>&1
+if [ ! -s $report ]; then
+    echo "Failed: no report written"
+    exit 1
+fi
+
+failed=0
+
+# column of the report line of the function matching the regexp,
+# the function name is the rest of the line after the third column
+column ()
+{
+    awk -v re="$1" -v col=$2 '
+	{ name = $4; for (i = 5; i <= NF; i++) name = name " " $i }
+	name ~ re { print $col }' $report
+}
+
+check ()
+{
+    if awk -v v="$2" "BEGIN { exit !(v $3) }"; then
+	echo "Ok: $1"
+    else
+	echo "Failed: $1 is '$2', expected $3"
+	failed=1
+    fi
+}
+
+check "calls of down" "$(column '^(.*::)?down$' 1)" "== 4"
+check "calls of twice" "$(column '^(.*::)?twice$' 1)" "== 2"
+check "calls of sleep" "$(column '^sleep : ' 1)" "== 3"
+check "calls of size (string)" "$(column '^size : integer \\(string\\)$' 1)" "== 2"
+check "calls of size (list)" "$(column '^size : integer \\((const )?list' 1)" "== 1"
+check "inclusive ms of down" "$(column '^(.*::)?down$' 2)" ">= 300 && v < 450"
+check "exclusive ms of down" "$(column '^(.*::)?down$' 3)" "< 100"
+
+[ $failed = 0 ] && rm -f $report
+exit $failed
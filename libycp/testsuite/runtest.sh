@@ -8,6 +8,8 @@ export EF_ALLOW_MALLOC_0=1
 export Y2SILENTSEARCH=1
 # for float::tolstring
 export LC_NUMERIC=cs_CZ.UTF8
+# for lsort, "ch" sorts after "h"
+export LC_COLLATE=cs_CZ.UTF8
 
-(./runycp -l - -I tests/Include -M tests/Module $1 >$2) 2>&1 | grep -F -v 'Electric Fence' | grep -F -v " <0> " | grep -v "^$" | sed 's/^....-..-.. ..:..:.. [^)]*) //g' > $3
+(./runycp $4 -l - -I tests/Include -M tests/Module $1 >$2) 2>&1 | grep -F -v 'Electric Fence' | grep -F -v " <0> " | grep -v "^$" | sed 's/^....-..-.. ..:..:.. [^)]*) //g' > $3
 exit 0
@@ -18,6 +18,7 @@
 /-*/
 
 #include <stdio.h>
+#include <locale.h>
 #include <ycp/YCode.h>
 #include <ycp/Parser.h>
 #include <ycp/y2log.h>
@@ -68,6 +69,10 @@ main (int argc, const char *argv[])
     const char *fname = 0;
     FILE *infile = stdin;
     bool make_depends = false;
+    bool stream_input = false;
+
+    // lsort collates by LC_COLLATE, like in Y2WFMComponent
+    setlocale (LC_COLLATE, "");
 
     YCPPathSearch::initialize ();
 
@@ -122,6 +127,12 @@ main (int argc, const char *argv[])
 		    YCPPathSearch::addPath (YCPPathSearch::Module, path);
 		}
 	    }
+	    else if ((argv[argp][0] == '-')
+	        && (argv[argp][1] == 'u')
+	        && (argv[argp][2] == 0))
+	    {
+		stream_input = true;
+	    }
 	    else if ((argv[argp][0] == '-')
 	        && (argv[argp][1] == '-')
 	        && (strcmp (argv[argp] + 2, "depends") == 0))
@@ -135,7 +146,7 @@ main (int argc, const char *argv[])
 	    }
 	    else
 	    {
-		fprintf (stderr, "Bad argument '%s'\nUsage: runycp [-l log] {-I include-path} {-M module-path} [name.ycp]\n", argv[argp]);
+		fprintf (stderr, "Bad argument '%s'\nUsage: runycp [-l log] [-u] {-I include-path} {-M module-path} [name.ycp]\n", argv[argp]);
 		return 1;
 	    }
 	    argp++;
@@ -166,7 +177,9 @@ main (int argc, const char *argv[])
     }
 
     parser->setInput (infile, fname);
-    parser->setBuffered();
+    // -u reads unbuffered like a protocol stream, see below
+    if (!stream_input)
+	parser->setBuffered();
     if (make_depends)
 	parser->setDepends();
 
@@ -204,6 +217,13 @@ main (int argc, const char *argv[])
 	y2debug ("\n------------------------------------------- done");
 	printf ("(%s)\n", value.isNull() ? "nil" : value->toString().c_str());
 
+	if (stream_input)
+	{
+	    // a new scanner for each value, like y2base -s, it must
+	    // not have read past the end of the previous value
+	    parser->setInput (infile, fname);
+	}
+
     }
 
     delete parser;
@@ -0,0 +1,110 @@
+/*
+    testMap.cc
+
+    test program for the string key index of YCPMap, add and remove
+    must keep it in step with the map once find has built it
+*/
+
+#include "ycp/y2log.h"
+#include "ycp/YCPMap.h"
+#include "ycp/YCPString.h"
+#include "ycp/YCPInteger.h"
+#include "ycp/YCPSymbol.h"
+
+#include <stdio.h>
+
+using namespace std;
+
+
+static int failed = 0;
+
+
+void
+check (const char *what, bool ok)
+{
+    if (ok)
+    {
+	printf ("Ok: %s\n", what);
+    }
+    else
+    {
+	printf ("Failed: %s\n", what);
+	failed++;
+    }
+}
+
+
+static YCPString
+key (int i)
+{
+    char buf[16];
+    snprintf (buf, sizeof (buf), "key%02d", i);
+    return YCPString (buf);
+}
+
+
+static bool
+hasValue (const YCPMap &m, const YCPValue &k, long long v)
+{
+    YCPValue val = m->value (k);
+    return !val.isNull () && val->isInteger () && val->asInteger ()->value () == v;
+}
+
+
+int
+main ()
+{
+    YCPMap m;
+    for (int i = 0; i < 24; i++)
+	m->add (key (i), YCPInteger (i));
+    // keys of other types are not in the index
+    m->add (YCPInteger (7), YCPInteger (-7));
+    m->add (YCPSymbol ("key07"), YCPInteger (-8));
+
+    // twice the threshold, the index is built on the way, the keys
+    // are new YCPStrings and not the ones in the map
+    bool found = true;
+    for (int i = 0; i < 32; i++)
+	found = hasValue (m, key (i % 24), i % 24) && found;
+    check ("lookups while the index is built", found);
+
+    // m is the only reference, add and remove change the map in place
+    m->add (YCPString ("key99"), YCPInteger (99));
+    check ("add a new key", hasValue (m, key (99), 99) && m->size () == 27);
+
+    m->add (YCPString ("key05"), YCPInteger (500));
+    check ("overwrite a key", hasValue (m, key (5), 500) && m->size () == 27);
+
+    m->remove (YCPString ("key10"));
+    check ("remove a key", m->size () == 26);
+    check ("lookup of the removed key", m->value (key (10)).isNull ());
+    check ("haskey of the removed key", !m->hasKey (key (10)));
+    check ("haskey of its neighbours", m->hasKey (key (9)) && m->hasKey (key (11)));
+
+    m->remove (YCPString ("nokey"));
+    check ("remove a missing key", m->size () == 26);
+
+    m->add (YCPString ("key10"), YCPInteger (1010));
+    check ("add the removed key again", hasValue (m, key (10), 1010));
+
+    check ("other key types", hasValue (m, YCPInteger (7), -7)
+	   && hasValue (m, YCPSymbol ("key07"), -8) && hasValue (m, key (7), 7));
+
+    // iteration follows the order of the keys, not the index
+    string keys;
+    for (YCPMap::const_iterator pos = m->begin (); pos != m->end (); ++pos)
+    {
+	if (pos->first->isString ())
+	    keys += pos->first->asString ()->value () + " ";
+    }
+    string expected;
+    for (int i = 0; i < 24; i++)
+	expected += key (i)->value () + " ";
+    expected += "key99 ";
+    check ("iteration order", keys == expected);
+
+    m->remove (YCPInteger (7));
+    check ("remove an integer key", !m->hasKey (YCPInteger (7)) && m->hasKey (key (7)));
+
+    return failed == 0 ? 0 : 1;
+}
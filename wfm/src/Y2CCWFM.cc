@@ -29,6 +29,9 @@
 #include <unistd.h>
 #include <regex.h>
 #include <sys/stat.h>
+#include <stdlib.h>
+
+#include <map>
 
 #include <ycp/y2log.h>
 #include <Y2CCWFM.h>
@@ -48,6 +51,108 @@
 #include <scr/SCR.h>
 #include "WFM.h"
 
+/**
+ * Cache of decoded clients. Installation workflows call the same clients
+ * many times; keep their code so that a repeated WFM::call does not have
+ * to parse the source or read the bytecode again. An entry is valid as long
+ * as the file it was loaded from keeps its modification time and size.
+ * The number of entries is bounded by Y2WFMCLIENTCACHE (0 disables).
+ */
+class ClientCodeCache
+{
+public:
+    ClientCodeCache ()
+	: m_limit (32)
+	, m_clock (0)
+	, m_hits (0)
+	, m_misses (0)
+    {
+	const char *env = getenv ("Y2WFMCLIENTCACHE");
+	if (env)
+	    m_limit = atoi (env);
+    }
+
+    /**
+     * Returns the cached code for file, or an empty value if there
+     * is none or the file has changed since.
+     */
+    YCPCode lookup (const string& file, const struct stat& st)
+    {
+	if (m_limit <= 0)
+	    return YCPNull ();
+
+	entries_t::iterator it = m_entries.find (file);
+	if (it != m_entries.end ()
+	    && it->second.mtime == st.st_mtime
+	    && it->second.size == st.st_size)
+	{
+	    it->second.used = ++m_clock;
+	    ++m_hits;
+	    y2debug ("Client cache hit for %s (%lu hits, %lu misses)",
+		     file.c_str (), m_hits, m_misses);
+	    return it->second.code;
+	}
+
+	if (it != m_entries.end ())
+	    m_entries.erase (it);
+
+	++m_misses;
+	y2debug ("Client cache miss for %s (%lu hits, %lu misses)",
+		 file.c_str (), m_hits, m_misses);
+	return YCPNull ();
+    }
+
+    void insert (const string& file, const struct stat& st, const YCPCode& code)
+    {
+	if (m_limit <= 0)
+	    return;
+
+	// evict the least recently used entry
+	if (m_entries.size () >= (size_t) m_limit
+	    && m_entries.find (file) == m_entries.end ())
+	{
+	    entries_t::iterator victim = m_entries.begin ();
+	    for (entries_t::iterator it = m_entries.begin (); it != m_entries.end (); ++it)
+	    {
+		if (it->second.used < victim->second.used)
+		    victim = it;
+	    }
+	    m_entries.erase (victim);
+	}
+
+	entry_t& e = m_entries[file];
+	e.mtime = st.st_mtime;
+	e.size = st.st_size;
+	e.used = ++m_clock;
+	e.code = code;
+    }
+
+private:
+    struct entry_t
+    {
+	entry_t () : mtime (0), size (0), used (0), code (YCPNull ()) {}
+	time_t mtime;
+	off_t size;
+	unsigned long used;
+	YCPCode code;
+    };
+
+    typedef map<string, entry_t> entries_t;
+
+    entries_t m_entries;
+    int m_limit;
+    unsigned long m_clock;
+    unsigned long m_hits;
+    unsigned long m_misses;
+};
+
+static ClientCodeCache &
+clientCache ()
+{
+    static ClientCodeCache cache;
+    return cache;
+}
+
 Y2CCWFM::Y2CCWFM()
     : Y2ComponentCreator(Y2ComponentBroker::SCRIPT)
 {
@@ -133,10 +238,22 @@ Y2Component *Y2CCWFM::createInLevel(const char *name, int level, int) const
     initializeBuiltins ();
 
     // check, if there is a newer YBC client
-    YCPCode script;
+    YCPCode script = YCPNull ();
 
     string ybc_filename = YCPPathSearch::bytecodeForFile (fullname);
-    if (ybc_filename.empty ())
+    const string& source = ybc_filename.empty () ? fullname : ybc_filename;
+
+    struct stat st;
+    bool have_stat = stat (source.c_str (), &st) == 0;
+    if (have_stat)
+	script = clientCache ().lookup (source, st);
+
+    if (!script.isNull ())
+    {
+	fclose (file);
+	y2milestone ("Using cached code of %s", source.c_str ());
+    }
+    else if (ybc_filename.empty ())
     {
 	// Parse Script
 	Parser parser(file, fullname.c_str());
@@ -149,6 +266,7 @@ Y2Component *Y2CCWFM::createInLevel(const char *name, int level, int) const
     }
     else
     {
+	fclose (file);
 	y2milestone ("Using bytecode file %s", ybc_filename.c_str ());
 	script = YCPCode ( Bytecode::readFile (ybc_filename) );
 	y2milestone ("Bytecode file loaded");
@@ -160,6 +278,9 @@ Y2Component *Y2CCWFM::createInLevel(const char *name, int level, int) const
 
     if (script->code () != 0 && !script->code ()->isError ())
     {
+	if (have_stat)
+	    clientCache ().insert (source, st, script);
+
 	Y2WFMComponent *s = Y2WFMComponent::instance ();
 	s->setupComponent (modulename, fullname, script);
 	return s;